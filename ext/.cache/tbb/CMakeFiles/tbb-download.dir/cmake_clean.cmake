@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tbb-download"
+  "CMakeFiles/tbb-download-complete"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-build"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-configure"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-download"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-install"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-mkdir"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-patch"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-test"
+  "tbb-download-prefix/src/tbb-download-stamp/tbb-download-update"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/tbb-download.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/ext/tbb"
+  "/root/repo/_gate_build/tbb-build"
+  "/root/repo/ext/.cache/tbb/tbb-download-prefix"
+  "/root/repo/ext/.cache/tbb/tbb-download-prefix/tmp"
+  "/root/repo/ext/.cache/tbb/tbb-download-prefix/src/tbb-download-stamp"
+  "/root/repo/ext/.cache/tbb/tbb-download-prefix/src"
+  "/root/repo/ext/.cache/tbb/tbb-download-prefix/src/tbb-download-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/ext/.cache/tbb/tbb-download-prefix/src/tbb-download-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/ext/.cache/tbb/tbb-download-prefix/src/tbb-download-stamp${cfgdir}") # cfgdir has leading slash
+endif()
@@ -6,14 +6,13 @@
 //
 
 #include "Energy.hpp"
+#include "RunContext.hpp"
 
 #include <igl/avg_edge_length.h>
 
 #include <fstream>
 #include <iostream>
 
-extern std::ofstream logFile;
-
 namespace OptCuts {
     
     Energy::Energy(bool p_needRefactorize) :
@@ -77,9 +76,11 @@ namespace OptCuts {
         
         std::cout << "L2 dist = " << dif_L2 << ", relErr = " << relErr << std::endl;
         
-        logFile << "check gradient:" << std::endl;
-        logFile << "g_symbolic =\n" << gradient_symbolic << std::endl;
-        logFile << "g_finiteDiff = \n" << gradient_finiteDiff << std::endl;
+        // into the log of the run the mesh belongs to, if any
+        std::ostream& logFile = (data.context ? static_cast<std::ostream&>(data.context->logFile) : std::cout);
+        logFile << "check gradient:\n";
+        logFile << "g_symbolic =\n" << gradient_symbolic << "\n";
+        logFile << "g_finiteDiff = \n" << gradient_finiteDiff << "\n";
     }
     
     void Energy::checkHessian(const TriMesh& data, bool useTriplet) const
@@ -94,7 +95,7 @@ namespace OptCuts {
         hessian_finiteDiff.resize(data.V.rows() * 2, data.V.rows() * 2);
         for(int vI = 0; vI < data.V.rows(); vI++)
         {
-            if(data.fixedVert.find(vI) != data.fixedVert.end()) {
+            if(data.isFixedVert(vI)) {
                 hessian_finiteDiff.insert(vI * 2, vI * 2) = 1.0;
                 hessian_finiteDiff.insert(vI * 2 + 1, vI * 2 + 1) = 1.0;
                 continue;
@@ -108,7 +109,7 @@ namespace OptCuts {
                 Eigen::VectorXd hessian_colI = (gradient_perturbed - gradient0) / h;
                 int colI = vI * 2 + dimI;
                 for(int rowI = 0; rowI < data.V.rows() * 2; rowI++) {
-                    if(data.fixedVert.find(rowI / 2) != data.fixedVert.end()) {
+                    if(data.isFixedVert(rowI / 2)) {
                         continue;
                     }
                     
@@ -140,9 +141,11 @@ namespace OptCuts {
         
         std::cout << "L2 dist = " << dif_L2 << ", relErr = " << relErr << std::endl;
         
-        logFile << "check hessian:" << std::endl;
-        logFile << "h_symbolic =\n" << hessian_symbolic << std::endl;
-        logFile << "h_finiteDiff = \n" << hessian_finiteDiff << std::endl;
+        // into the log of the run the mesh belongs to, if any
+        std::ostream& logFile = (data.context ? static_cast<std::ostream&>(data.context->logFile) : std::cout);
+        logFile << "check hessian:\n";
+        logFile << "h_symbolic =\n" << hessian_symbolic << "\n";
+        logFile << "h_finiteDiff = \n" << hessian_finiteDiff << "\n";
     }
     
     
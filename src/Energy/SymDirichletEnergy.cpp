@@ -7,6 +7,7 @@
 
 #include "SymDirichletEnergy.hpp"
 #include "IglUtils.hpp"
+#include "RunContext.hpp"
 
 #include <igl/cotmatrix.h>
 #include <igl/massmatrix.h>
@@ -17,8 +18,6 @@
 #include <fstream>
 #include <cfloat>
 
-extern std::ofstream logFile;
-
 namespace OptCuts {
     
     void SymDirichletEnergy::getEnergyValPerElem(const TriMesh& data, Eigen::VectorXd& energyValPerElem, bool uniformWeight) const
@@ -406,7 +405,7 @@ namespace OptCuts {
             Eigen::VectorXi& vInd = vInds[triI];
             vInd = triVInd;
             for(int vI = 0; vI < 3; vI++) {
-                if(data.fixedVert.find(vInd[vI]) != data.fixedVert.end()) {
+                if(data.isFixedVert(vInd[vI])) {
                     vInd[vI] = -1;
                 }
             }
@@ -527,7 +526,7 @@ namespace OptCuts {
             Eigen::VectorXi& vInd = vInds[triI];
             vInd = triVInd;
             for(int vI = 0; vI < 3; vI++) {
-                if(data.fixedVert.find(vInd[vI]) != data.fixedVert.end()) {
+                if(data.isFixedVert(vInd[vI])) {
                     vInd[vI] = -1;
                 }
             }
@@ -611,7 +610,9 @@ namespace OptCuts {
     
     void SymDirichletEnergy::checkEnergyVal(const TriMesh& data) const
     {
-        logFile << "check energyVal computation..." << std::endl;
+        // into the log of the run the mesh belongs to, if any
+        std::ostream& logFile = (data.context ? static_cast<std::ostream&>(data.context->logFile) : std::cout);
+        logFile << "check energyVal computation...\n";
         
         const double normalizer_div = data.surfaceArea;
         
@@ -632,7 +633,7 @@ namespace OptCuts {
             const Eigen::Vector2d U3m1 = U[2];//(P3m1.dot(P2m1) / U2m1[0], P3m1.cross(P2m1).norm() / U2m1[0]);
             
             const double area_U = 0.5 * (U2m1[0] * U3m1[1] - U2m1[1] * U3m1[0]);
-            logFile << "areas: " << data.triArea[triI] << ", " << area_U << std::endl;
+            logFile << "areas: " << data.triArea[triI] << ", " << area_U << "\n";
             
             const double w = data.triArea[triI] / normalizer_div;
             energyValPerTri[triI] = w * (1.0 + data.triAreaSq[triI] / area_U / area_U) *
@@ -641,7 +642,7 @@ namespace OptCuts {
             err += energyValPerTri[triI] - w * 4.0;
         }
         std::cout << "energyVal computation error = " << err << std::endl;
-        logFile << "energyVal computation error = " << err << std::endl;
+        logFile << "energyVal computation error = " << err << "\n";
     }
     
     SymDirichletEnergy::SymDirichletEnergy(void) :
@@ -38,10 +38,13 @@ namespace OptCuts {
     }
     
     template <typename vectorTypeI, typename vectorTypeS>
-    void CHOLMODSolver<vectorTypeI, vectorTypeS>::set_pattern(const std::vector<std::set<int>>& vNeighbor,
-                                                              const std::set<int>& fixedVert)
+    void CHOLMODSolver<vectorTypeI, vectorTypeS>::set_pattern(const VertexAdjacency& vNeighbor,
+                                                              const std::vector<bool>& isFixedVert)
     {
-        Base::set_pattern(vNeighbor, fixedVert);
+        Base::set_pattern(vNeighbor, isFixedVert);
+        if(!Base::patternChanged) {
+            return;
+        }
         
         //TODO: directly save into A
         if(!A) {
@@ -49,13 +52,13 @@ namespace OptCuts {
                                         true, true, -1, CHOLMOD_REAL, &cm);
             // -1: upper right part will be ignored during computation
         }
-        else if(A->nrow != Base::numRows) {
+        else if((A->nrow != Base::numRows) || (A->nzmax < Base::ja.size())) {
             cholmod_free_sparse(&A, &cm);
             A = cholmod_allocate_sparse(Base::numRows, Base::numRows, Base::ja.size(),
                                         true, true, -1, CHOLMOD_REAL, &cm);
             // -1: upper right part will be ignored during computation
         }
-        Base::ia.array() -= 1; Base::ja.array() -= 1; // CHOLMOD's index starts from 0
+        Base::setIndexBase(0); // CHOLMOD's index starts from 0
         memcpy(A->i, Base::ja.data(), Base::ja.size() * sizeof(Base::ja[0]));
         memcpy(A->p, Base::ia.data(), Base::ia.size() * sizeof(Base::ia[0]));
     }
@@ -63,6 +66,7 @@ namespace OptCuts {
     void  CHOLMODSolver<vectorTypeI, vectorTypeS>::set_pattern(const Eigen::SparseMatrix<double>& mtr)
     {
         //TODO: extract, manage Base list
+        Base::invalidatePatternCache(0);
         Base::numRows = static_cast<int>(mtr.rows());
         if(!A) {
             A = cholmod_allocate_sparse(Base::numRows, Base::numRows, mtr.nonZeros(),
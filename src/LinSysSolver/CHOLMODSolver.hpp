@@ -36,8 +36,8 @@ namespace OptCuts {
         
         void set_type(int threadAmt, int _mtype, bool is_upper_half = false);
         
-        void set_pattern(const std::vector<std::set<int>>& vNeighbor,
-                         const std::set<int>& fixedVert);
+        void set_pattern(const VertexAdjacency& vNeighbor,
+                         const std::vector<bool>& isFixedVert);
         void set_pattern(const Eigen::SparseMatrix<double>& mtr); //NOTE: mtr must be SPD
         
         void update_a(const vectorTypeI &II,
@@ -18,21 +18,23 @@ namespace OptCuts {
     }
     
     template <typename vectorTypeI, typename vectorTypeS>
-    void EigenLibSolver<vectorTypeI, vectorTypeS>::set_pattern(const std::vector<std::set<int>>& vNeighbor,
-                                                               const std::set<int>& fixedVert)
+    void EigenLibSolver<vectorTypeI, vectorTypeS>::set_pattern(const VertexAdjacency& vNeighbor,
+                                                               const std::vector<bool>& isFixedVert)
     {
         if(useDense) {
             Base::numRows = static_cast<int>(vNeighbor.size()) * 2;
             coefMtr_dense.resize(Base::numRows, Base::numRows);
         }
         else {
-            Base::set_pattern(vNeighbor, fixedVert);
+            Base::set_pattern(vNeighbor, isFixedVert);
+            if(!Base::patternChanged) {
+                return;
+            }
             
             //TODO: directly save into mtr
             coefMtr.resize(Base::numRows, Base::numRows);
             coefMtr.reserve(Base::ja.size());
-            Base::ia.array() -= 1.0;
-            Base::ja.array() -= 1.0;
+            Base::setIndexBase(0);
             memcpy(coefMtr.innerIndexPtr(), Base::ja.data(), Base::ja.size() * sizeof(Base::ja[0]));
             memcpy(coefMtr.outerIndexPtr(), Base::ia.data(), Base::ia.size() * sizeof(Base::ia[0]));
         }
@@ -40,6 +42,7 @@ namespace OptCuts {
     template <typename vectorTypeI, typename vectorTypeS>
     void EigenLibSolver<vectorTypeI, vectorTypeS>::set_pattern(const Eigen::SparseMatrix<double>& mtr) //NOTE: mtr must be SPD
     {
+        Base::invalidatePatternCache(Base::indexBase);
         if(useDense) {
             coefMtr_dense = Eigen::MatrixXd(mtr);
         }
@@ -9,6 +9,7 @@
 #define LinSysSolver_hpp
 
 #include "Types.hpp"
+#include "VertexAdjacency.hpp"
 
 #include <Eigen/Eigen>
 #include <Eigen/Sparse>
@@ -16,6 +17,8 @@
 #include <set>
 #include <map>
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
 
 namespace OptCuts {
     
@@ -27,6 +30,18 @@ namespace OptCuts {
         Eigen::VectorXi ia, ja;
         std::vector<std::map<int, int>> IJ2aI;
         Eigen::VectorXd a;
+        int indexBase = 1; // ia and ja index from 1, subclasses may shift them to 0
+        // cached pattern: per row the free upper-right columns in ascending order, or -1 for
+        // a fixed row, at [rowPatternOffset[rowI], rowPatternOffset[rowI + 1]) of rowPatternCols
+        std::vector<int> rowPatternOffset, rowPatternCols;
+        std::vector<uint64_t> rowPatternHash; // of the rows of the cached pattern
+        bool patternChanged = true; // by the last set_pattern call
+        
+    protected:
+        static uint64_t hashCombine(uint64_t seed, uint64_t val)
+        {
+            return seed ^ ((val + 0x9E3779B97F4A7C15ull) * 0xBF58476D1CE4E5B9ull + (seed << 6) + (seed >> 2));
+        }
         
     public:
         virtual ~LinSysSolver(void) {};
@@ -34,17 +49,79 @@ namespace OptCuts {
     public:
         virtual void set_type(int threadAmt, int _mtype, bool is_upper_half = false) = 0;
         
-        virtual void set_pattern(const std::vector<std::set<int>>& vNeighbor,
-                                 const std::set<int>& fixedVert)
+        // the rows before the first one that differs from the cached pattern are kept,
+        // if nothing differs, patternChanged is false and analyze_pattern can be skipped,
+        // vertices beyond the size of isFixedVert are free
+        virtual void set_pattern(const VertexAdjacency& vNeighbor,
+                                 const std::vector<bool>& isFixedVert_in)
         {
+            const auto isFixedVert = [&isFixedVert_in](int vI) {
+                return (vI < isFixedVert_in.size()) && isFixedVert_in[vI];
+            };
+            
+            std::vector<int> rowPatternOffset_new(vNeighbor.size() + 1), rowPatternCols_new;
+            std::vector<uint64_t> rowPatternHash_new(vNeighbor.size());
+            rowPatternOffset_new[0] = 0;
+            rowPatternCols_new.reserve(vNeighbor.nnz() / 2 + vNeighbor.size());
+            for(int rowI = 0; rowI < vNeighbor.size(); rowI++) {
+                uint64_t rowHash = hashCombine(rowI, isFixedVert(rowI));
+                if(!isFixedVert(rowI)) {
+                    for(const auto& colI : vNeighbor[rowI]) {
+                        if((colI > rowI) && !isFixedVert(colI)) {
+                            rowPatternCols_new.emplace_back(colI);
+                            rowHash = hashCombine(rowHash, colI);
+                        }
+                    }
+                }
+                else {
+                    rowPatternCols_new.emplace_back(-1);
+                }
+                rowPatternOffset_new[rowI + 1] = static_cast<int>(rowPatternCols_new.size());
+                rowPatternHash_new[rowI] = rowHash;
+            }
+            
+            // different hashes reject a row quickly, equal ones are confirmed by comparing the columns
+            const auto isRowUnchanged = [&](int rowI) {
+                if(rowPatternHash[rowI] != rowPatternHash_new[rowI]) {
+                    return false;
+                }
+                const int colAmt = rowPatternOffset_new[rowI + 1] - rowPatternOffset_new[rowI];
+                return (rowPatternOffset[rowI + 1] - rowPatternOffset[rowI] == colAmt) &&
+                       std::equal(rowPatternCols_new.begin() + rowPatternOffset_new[rowI],
+                                  rowPatternCols_new.begin() + rowPatternOffset_new[rowI + 1],
+                                  rowPatternCols.begin() + rowPatternOffset[rowI]);
+            };
+            int startRowI = 0;
+            const int cachedRowAmt = std::min(static_cast<int>(rowPatternHash.size()), vNeighbor.size());
+            while((startRowI < cachedRowAmt) && isRowUnchanged(startRowI)) {
+                startRowI++;
+            }
+            patternChanged = ((rowPatternHash.size() != vNeighbor.size()) || (startRowI < vNeighbor.size()));
+            if(!patternChanged) {
+                return;
+            }
+            rowPatternOffset.swap(rowPatternOffset_new);
+            rowPatternCols.swap(rowPatternCols_new);
+            rowPatternHash.swap(rowPatternHash_new);
+            
+            // keep the CSR prefix of the unchanged rows
             numRows = static_cast<int>(vNeighbor.size()) * DIM;
-            ia.resize(vNeighbor.size() * DIM + 1);
+            if(startRowI > 0) {
+                const int prefixNNZ = ia[startRowI * DIM] - indexBase;
+                ia.head(startRowI * DIM + 1).array() += 1 - indexBase;
+                ja.conservativeResize(prefixNNZ);
+                ja.array() += 1 - indexBase;
+            }
+            else {
+                ja.resize(0); // colI of each element
+            }
+            indexBase = 1;
+            ia.conservativeResize(vNeighbor.size() * DIM + 1);
             ia[0] = 1; // 1 + nnz above row i
-            ja.resize(0); // colI of each element
-            IJ2aI.resize(0); // map from matrix index to ja index
+            IJ2aI.resize(startRowI * DIM); // map from matrix index to ja index
             IJ2aI.resize(vNeighbor.size() * DIM);
-            for(int rowI = 0; rowI < vNeighbor.size(); rowI++) {
-                if(fixedVert.find(rowI) == fixedVert.end()) {
+            for(int rowI = startRowI; rowI < vNeighbor.size(); rowI++) {
+                if(!isFixedVert(rowI)) {
                     int oldSize_ja = static_cast<int>(ja.size());
                     IJ2aI[rowI * DIM][rowI * DIM] = oldSize_ja;
                     IJ2aI[rowI * DIM][rowI * DIM + 1] = oldSize_ja + 1;
@@ -60,7 +137,7 @@ namespace OptCuts {
                     
                     int nnz_rowI = 1;
                     for(const auto& colI : vNeighbor[rowI]) {
-                        if(fixedVert.find(colI) == fixedVert.end()) {
+                        if(!isFixedVert(colI)) {
                             if(colI > rowI) {
                                 // only the lower-left part
                                 // colI > rowI means upper-right, but we are preparing CSR here
@@ -135,6 +212,26 @@ namespace OptCuts {
         }
         virtual void set_pattern(const Eigen::SparseMatrix<double>& mtr) = 0; //NOTE: mtr must be SPD
         
+        // shift ia and ja to index from p_indexBase
+        void setIndexBase(int p_indexBase)
+        {
+            if(p_indexBase != indexBase) {
+                ia.array() += p_indexBase - indexBase;
+                ja.array() += p_indexBase - indexBase;
+                indexBase = p_indexBase;
+            }
+        }
+        // for patterns not set from vNeighbor
+        void invalidatePatternCache(int p_indexBase)
+        {
+            rowPatternOffset.resize(0);
+            rowPatternCols.resize(0);
+            rowPatternHash.resize(0);
+            patternChanged = true;
+            indexBase = p_indexBase;
+        }
+        bool isPatternChanged(void) const { return patternChanged; }
+        
         virtual void update_a(const vectorTypeI &II,
                               const vectorTypeI &JJ,
                               const vectorTypeS &SS)
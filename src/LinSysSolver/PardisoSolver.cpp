@@ -289,6 +289,7 @@ namespace OptCuts {
                 currI = M(i,0);
             }
         }
+        Base::invalidatePatternCache(1);
         
     //#define PLOTS_PARDISO
     #ifdef PLOTS_PARDISO
@@ -313,10 +314,10 @@ namespace OptCuts {
     }
 
     template <typename vectorTypeI, typename vectorTypeS>
-    void PardisoSolver<vectorTypeI,vectorTypeS>::set_pattern(const std::vector<std::set<int>>& vNeighbor,
-                                                             const std::set<int>& fixedVert)
+    void PardisoSolver<vectorTypeI,vectorTypeS>::set_pattern(const VertexAdjacency& vNeighbor,
+                                                             const std::vector<bool>& isFixedVert)
     {
-        Base::set_pattern(vNeighbor, fixedVert);
+        Base::set_pattern(vNeighbor, isFixedVert);
         
     #ifdef PLOTS_PARDISO
         printf("ia: ");
@@ -357,6 +358,7 @@ namespace OptCuts {
         //NOTE: Pardiso requires the indices start from 1
         Base::ja.array() += 1;
         Base::ia.array() += 1;
+        Base::invalidatePatternCache(1);
     }
 
     template <typename vectorTypeI, typename vectorTypeS>
@@ -55,8 +55,8 @@ namespace OptCuts {
         void set_pattern(const vectorTypeI &II,
                          const vectorTypeI &JJ,
                          const vectorTypeS &SS);
-        void set_pattern(const std::vector<std::set<int>>& vNeighbor,
-                         const std::set<int>& fixedVert);
+        void set_pattern(const VertexAdjacency& vNeighbor,
+                         const std::vector<bool>& isFixedVert);
         void set_pattern(const Eigen::SparseMatrix<double>& mtr);
         
         void analyze_pattern();
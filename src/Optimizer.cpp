@@ -8,6 +8,8 @@
 #include "Optimizer.hpp"
 
 #include "IglUtils.hpp"
+#include "MetricsSink.hpp"
+#include "Profiler.hpp"
 #include "SymDirichletEnergy.hpp"
 #include "Timer.hpp"
 
@@ -21,25 +23,20 @@
 
 #include <igl/avg_edge_length.h>
 
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <string>
 
-extern OptCuts::MethodType methodType;
-extern std::string outputFolderPath;
-extern bool fractureMode;
-
-extern std::ofstream logFile;
-extern Timer timer, timer_step;
-
 namespace OptCuts
 {
 
-    Optimizer::Optimizer(const TriMesh& p_data0, const std::vector<Energy*>& p_energyTerms, const std::vector<double>& p_energyParams,
-                         int p_propagateFracture, bool p_mute, bool p_scaffolding, const Eigen::MatrixXd& UV_bnds, const Eigen::MatrixXi& E,
-                         const Eigen::VectorXi& bnd, bool p_useDense)
-        : data0(p_data0), energyTerms(p_energyTerms), energyParams(p_energyParams)
+    Optimizer::Optimizer(RunContext& p_context, const TriMesh& p_data0, const std::vector<Energy*>& p_energyTerms,
+                         const std::vector<double>& p_energyParams, int p_propagateFracture, bool p_mute, bool p_scaffolding,
+                         const Eigen::MatrixXd& UV_bnds, const Eigen::MatrixXi& E, const Eigen::VectorXi& bnd, bool p_useDense)
+        : context(p_context), data0(p_data0), energyTerms(p_energyTerms), energyParams(p_energyParams)
     {
         assert(energyTerms.size() == energyParams.size());
 
@@ -57,11 +54,19 @@ namespace OptCuts
         allowEDecRelTol = true;
         propagateFracture = p_propagateFracture;
         mute = p_mute;
+        snapshotFindExtrema = !mute;
+        incrementalScaffold = false;
+        scaffoldQualityThres = 0.2;
+        lineSearchTrialAmt = lineSearchAmt = lastLineSearchTrialAmt = 0;
+        lastStepSize = 0.0;
+        stateGen = 1;
+        energyValGen = energyValGen_scaffold = gradientGen = seamSparsityGen = 0;
+        energyValCacheHit = gradientCacheHit = seamSparsityCacheHit = 0;
 
         if (!mute)
         {
-            file_energyValPerIter.open(outputFolderPath + "energyValPerIter.txt");
-            file_gradientPerIter.open(outputFolderPath + "gradientPerIter.txt");
+            file_energyValPerIter.open(context.outputFolderPath + "energyValPerIter.txt");
+            file_gradientPerIter.open(context.outputFolderPath + "gradientPerIter.txt");
         }
 
         if (!data0.checkInversion())
@@ -102,17 +107,23 @@ namespace OptCuts
 
     Optimizer::~Optimizer(void)
     {
-        if (file_energyValPerIter.is_open())
-        {
-            file_energyValPerIter.close();
-        }
-        if (file_gradientPerIter.is_open())
-        {
-            file_gradientPerIter.close();
-        }
+        file_energyValPerIter.close();
+        file_gradientPerIter.close();
         delete linSysSolver;
     }
 
+    double Optimizer::getAvgLineSearchTrialAmt(void) const
+    {
+        return (lineSearchAmt ? (static_cast<double>(lineSearchTrialAmt) / lineSearchAmt) : 0.0);
+    }
+
+    void Optimizer::getEvalCacheHits(int& energyValHit, int& gradientHit, int& seamSparsityHit) const
+    {
+        energyValHit = energyValCacheHit;
+        gradientHit = gradientCacheHit;
+        seamSparsityHit = seamSparsityCacheHit;
+    }
+
     void Optimizer::computeLastEnergyVal(void) { computeEnergyVal(result, scaffold, lastEnergyVal); }
 
     TriMesh& Optimizer::getResult(void) { return result; }
@@ -127,6 +138,8 @@ namespace OptCuts
 
     int Optimizer::getIterNum(void) const { return globalIterNum; }
 
+    int Optimizer::getPropagateFracture(void) const { return propagateFracture; }
+
     int Optimizer::getTopoIter(void) const { return topoIter; }
 
     void Optimizer::setRelGL2Tol(double p_relTol)
@@ -138,9 +151,26 @@ namespace OptCuts
 
     void Optimizer::setAllowEDecRelTol(bool p_allowEDecRelTol) { allowEDecRelTol = p_allowEDecRelTol; }
 
+    void Optimizer::setSnapshotFindExtrema(bool p_snapshotFindExtrema)
+    {
+        snapshotFindExtrema = p_snapshotFindExtrema;
+        if (!snapshotFindExtrema)
+        {
+            data_findExtrema = TriMesh();
+        }
+    }
+
+    void Optimizer::setIncrementalScaffold(bool p_incrementalScaffold, double p_qualityThres)
+    {
+        incrementalScaffold = p_incrementalScaffold;
+        scaffoldQualityThres = p_qualityThres;
+    }
+
     void Optimizer::precompute(void)
     {
         result = data0;
+        result.context = &context;
+        stateGen++;
         if (scaffolding)
         {
             scaffold = Scaffold(result, UV_bnds_scaffold, E_scaffold, bnd_scaffold);
@@ -162,20 +192,23 @@ namespace OptCuts
         {
             if (!mute)
             {
-                timer_step.start(1);
+                context.timer_step.start(1);
             }
             linSysSolver->set_type(pardisoThreadAmt, -2);
-            linSysSolver->set_pattern(scaffolding ? vNeighbor_withScaf : result.vNeighbor, scaffolding ? fixedV_withScaf : result.fixedVert);
+            setLinSysPattern();
             linSysSolver->update_a(I_mtr, J_mtr, V_mtr);
             if (!mute)
             {
-                timer_step.stop();
-                timer_step.start(2);
+                context.timer_step.stop();
+                context.timer_step.start(2);
+            }
+            if (linSysSolver->isPatternChanged())
+            {
+                linSysSolver->analyze_pattern();
             }
-            linSysSolver->analyze_pattern();
             if (!mute)
             {
-                timer_step.stop();
+                context.timer_step.stop();
             }
             if (!needRefactorize)
             {
@@ -183,24 +216,27 @@ namespace OptCuts
                 {
                     if (!mute)
                     {
-                        timer_step.start(3);
+                        context.timer_step.start(3);
                     }
                     linSysSolver->factorize();
                     if (!mute)
                     {
-                        timer_step.stop();
+                        context.timer_step.stop();
                     }
                 }
                 catch (std::exception e)
                 {
-                    IglUtils::writeSparseMatrixToFile(outputFolderPath + "mtr_factorizeFail", I_mtr, J_mtr, V_mtr, true);
+                    IglUtils::writeSparseMatrixToFile(context.outputFolderPath + "mtr_factorizeFail", I_mtr, J_mtr, V_mtr, true);
                     exit(-1);
                 }
             }
         }
 
         lastEDec = 0.0;
-        data_findExtrema = data0;
+        if (snapshotFindExtrema)
+        {
+            data_findExtrema = data0;
+        }
         updateTargetGRes();
         computeEnergyVal(result, scaffold, lastEnergyVal);
         if (!mute)
@@ -212,12 +248,19 @@ namespace OptCuts
 
     int Optimizer::solve(int maxIter)
     {
-        static bool lastPropagate = false;
         for (int iterI = 0; iterI < maxIter; iterI++)
         {
+            OPTCUTS_PROFILE_NAMED_ZONE(newtonIterationZone, "newtonIteration", true);
+            const bool recordMetrics = ((!mute) && context.metricsSink.isOpen());
+            std::vector<double> stepTimings0;
+            const int lineSearchTrialAmt0 = lineSearchTrialAmt;
+            if (recordMetrics)
+            {
+                stepTimings0 = context.timer_step.timings();
+            }
             if (!mute)
             {
-                timer.start(1);
+                context.timer.start(1);
             }
             computeGradient(result, scaffold, gradient);
             const double sqn_g = gradient.squaredNorm();
@@ -226,47 +269,38 @@ namespace OptCuts
                 std::cout << "||gradient||^2 = " << sqn_g << ", targetGRes = " << targetGRes << std::endl;
                 writeGradL2NormToFile(false);
             }
-            if (sqn_g < targetGRes)
+            bool stopped = (sqn_g < targetGRes);
+            if (stopped)
             {
                 // converged
                 lastEDec = 0.0;
-                globalIterNum++;
-                if (!mute)
-                {
-                    timer.stop();
-                }
-                return 1;
+                lastStepSize = 0.0;
             }
             else
             {
-                if (solve_oneStep())
-                {
-                    globalIterNum++;
-                    if (!mute)
-                    {
-                        timer.stop();
-                    }
-                    return 1;
-                }
+                stopped = solve_oneStep();
             }
             globalIterNum++;
             if (!mute)
             {
-                timer.stop();
+                context.timer.stop();
+            }
+            if (recordMetrics)
+            {
+                writeNewtonMetrics(sqn_g, stopped, stepTimings0, lineSearchTrialAmt - lineSearchTrialAmt0);
+            }
+            if (stopped)
+            {
+                return 1;
             }
+            newtonIterationZone.end();
 
             if (propagateFracture > 0)
             {
                 if (!createFracture(lastEDec, propagateFracture))
                 {
                     // always perform the one decreasing E_w more
-                    if (scaffolding)
-                    {
-                        scaffold = Scaffold(result, UV_bnds_scaffold, E_scaffold, bnd_scaffold);
-                        result.scaffold = &scaffold;
-                        scaffold.mergeVNeighbor(result.vNeighbor, vNeighbor_withScaf);
-                        scaffold.mergeFixedV(result.fixedVert, fixedV_withScaf);
-                    }
+                    maintainScaffold();
 
                     if (lastPropagate)
                     {
@@ -281,18 +315,52 @@ namespace OptCuts
             }
             else
             {
-                if (scaffolding)
-                {
-                    scaffold = Scaffold(result, UV_bnds_scaffold, E_scaffold, bnd_scaffold);
-                    result.scaffold = &scaffold;
-                    scaffold.mergeVNeighbor(result.vNeighbor, vNeighbor_withScaf);
-                    scaffold.mergeFixedV(result.fixedVert, fixedV_withScaf);
-                }
+                maintainScaffold();
             }
         }
         return 0;
     }
 
+    void Optimizer::maintainScaffold(void)
+    {
+        if (!scaffolding)
+        {
+            return;
+        }
+        stateGen++;
+        OPTCUTS_PROFILE_ZONE("maintainScaffold");
+
+        bool retriangulated = false;
+        // local stencil scaffolds (with given E_scaffold) are cheap and always reconstructed
+        if (incrementalScaffold && (E_scaffold.rows() == 0) &&
+            scaffold.update(result, scaffoldQualityThres, retriangulated))
+        {
+            if (retriangulated)
+            {
+                scaffold.updateMergedVNeighbor(result.vNeighbor, vNeighbor_withScaf);
+            }
+            return;
+        }
+
+        scaffold = Scaffold(result, UV_bnds_scaffold, E_scaffold, bnd_scaffold);
+        result.scaffold = &scaffold;
+        scaffold.mergeVNeighbor(result.vNeighbor, vNeighbor_withScaf);
+        scaffold.mergeFixedV(result.fixedVert, fixedV_withScaf);
+    }
+
+    void Optimizer::setLinSysPattern(void)
+    {
+        if (scaffolding)
+        {
+            linSysSolver->set_pattern(vNeighbor_withScaf, fixedV_withScaf);
+        }
+        else
+        {
+            vNeighbor_linSys.build(result.vNeighbor);
+            linSysSolver->set_pattern(vNeighbor_linSys, result.fixedVertMask);
+        }
+    }
+
     void Optimizer::updatePrecondMtrAndFactorize(void)
     {
         if (needRefactorize)
@@ -315,18 +383,18 @@ namespace OptCuts
         {
             if (!mute)
             {
-                timer_step.start(1);
+                context.timer_step.start(1);
             }
             linSysSolver->update_a(I_mtr, J_mtr, V_mtr);
             if (!mute)
             {
-                timer_step.stop();
-                timer_step.start(3);
+                context.timer_step.stop();
+                context.timer_step.start(3);
             }
             linSysSolver->factorize();
             if (!mute)
             {
-                timer_step.stop();
+                context.timer_step.stop();
             }
         }
     }
@@ -336,6 +404,8 @@ namespace OptCuts
         topoIter = p_topoIter;
         globalIterNum = iterNum;
         result = config;
+        result.context = &context;
+        stateGen++;
         if (scaffolding)
         {
             scaffold = Scaffold(result, UV_bnds_scaffold, E_scaffold, bnd_scaffold);
@@ -347,11 +417,12 @@ namespace OptCuts
         updateEnergyData();
     }
 
-    void Optimizer::setPropagateFracture(bool p_prop) { propagateFracture = p_prop; }
+    void Optimizer::setPropagateFracture(int p_prop) { propagateFracture = p_prop; }
 
     void Optimizer::setScaffolding(bool p_scaffolding)
     {
         scaffolding = p_scaffolding;
+        stateGen++;
         if (scaffolding)
         {
             scaffold = Scaffold(result, UV_bnds_scaffold, E_scaffold, bnd_scaffold);
@@ -384,7 +455,7 @@ namespace OptCuts
             computeGradient(result, scaffold, gradient);
             if (gradient.squaredNorm() < targetGRes)
             {
-                logFile << "||g||^2 = " << gradient.squaredNorm() << " after fracture initiation!" << std::endl;
+                context.logFile << "||g||^2 = " << gradient.squaredNorm() << " after fracture initiation!\n";
             }
         }
 
@@ -408,30 +479,33 @@ namespace OptCuts
             {
                 if (!mute)
                 {
-                    timer_step.start(1);
+                    context.timer_step.start(1);
                 }
-                linSysSolver->set_pattern(scaffolding ? vNeighbor_withScaf : result.vNeighbor, scaffolding ? fixedV_withScaf : result.fixedVert);
+                setLinSysPattern();
                 linSysSolver->update_a(I_mtr, J_mtr, V_mtr);
                 if (!mute)
                 {
-                    timer_step.stop();
-                    timer_step.start(2);
+                    context.timer_step.stop();
+                    context.timer_step.start(2);
+                }
+                if (linSysSolver->isPatternChanged())
+                {
+                    linSysSolver->analyze_pattern();
                 }
-                linSysSolver->analyze_pattern();
                 if (!mute)
                 {
-                    timer_step.stop();
+                    context.timer_step.stop();
                 }
                 if (!needRefactorize)
                 {
                     if (!mute)
                     {
-                        timer_step.start(3);
+                        context.timer_step.start(3);
                     }
                     linSysSolver->factorize();
                     if (!mute)
                     {
-                        timer_step.stop();
+                        context.timer_step.stop();
                     }
                 }
             }
@@ -440,19 +514,24 @@ namespace OptCuts
 
     bool Optimizer::createFracture(int opType, const std::vector<int>& path, const Eigen::MatrixXd& newVertPos, bool allowPropagate)
     {
-        assert(methodType == MT_OPTCUTS);
+        assert(context.methodType == MT_OPTCUTS);
 
         topoIter++;
 
-        timer.start(0);
+        OPTCUTS_PROFILE_NAMED_ZONE(topologyStepZone, "topologyStep", true);
+        const double topoTime0 = context.timer.timing(0);
+        context.timer.start(0);
         bool isMerge = false;
-        data_findExtrema = result;  // potentially time-consuming
+        if (snapshotFindExtrema)
+        {
+            data_findExtrema = result;  // potentially time-consuming
+        }
         switch (opType)
         {
             case 0:  // boundary split
                 // std::cout << "boundary split without querying again" << std::endl;
                 result.splitEdgeOnBoundary(std::pair<int, int>(path[0], path[1]), newVertPos);
-                logFile << "boundary edge splitted without querying again" << std::endl;
+                context.logFile << "boundary edge splitted without querying again\n";
                 // TODO: process fractail here!
                 result.updateFeatures();
                 break;
@@ -460,7 +539,7 @@ namespace OptCuts
             case 1:  // interior split
                 // std::cout << "Interior split without querying again" << std::endl;
                 result.cutPath(path, true, 1, newVertPos);
-                logFile << "interior edge splitted without querying again" << std::endl;
+                context.logFile << "interior edge splitted without querying again\n";
                 result.fracTail.insert(path[0]);
                 result.fracTail.insert(path[2]);
                 result.curInteriorFracTails.first = path[0];
@@ -471,9 +550,7 @@ namespace OptCuts
             case 2:  // merge
                 // std::cout << "corner edge merged without querying again" << std::endl;
                 result.mergeBoundaryEdges(std::pair<int, int>(path[0], path[1]), std::pair<int, int>(path[1], path[2]), newVertPos.row(0));
-                logFile << "corner edge merged without querying again" << std::endl;
-
-                result.computeFeatures();  // TODO: only update locally
+                context.logFile << "corner edge merged without querying again\n";
                 isMerge = true;
                 break;
 
@@ -481,7 +558,8 @@ namespace OptCuts
                 assert(0);
                 break;
         }
-        timer.stop();
+        context.timer.stop();
+        stateGen++;
 
         if (scaffolding)
         {
@@ -491,13 +569,18 @@ namespace OptCuts
             scaffold.mergeFixedV(result.fixedVert, fixedV_withScaf);
         }
 
-        timer.start(3);
+        context.timer.start(3);
         updateEnergyData(true, false, true);
-        timer.stop();
+        context.timer.stop();
         fractureInitiated = true;
         if (!mute)
         {
             writeEnergyValToFile(false);
+            if (context.metricsSink.isOpen())
+            {
+                // E_dec is only known to the caller that queried the operation
+                writeTopologyMetrics(opType, true, path, std::numeric_limits<double>::quiet_NaN(), context.timer.timing(0) - topoTime0);
+            }
         }
 
         if (allowPropagate)
@@ -515,15 +598,20 @@ namespace OptCuts
             topoIter++;
         }
 
-        timer.start(0);
+        OPTCUTS_PROFILE_NAMED_ZONE(topologyStepZone, "topologyStep", true);
+        const double topoTime0 = context.timer.timing(0);
+        context.timer.start(0);
         bool changed = false;
         bool isMerge = false;
-        switch (methodType)
+        switch (context.methodType)
         {
             case MT_OPTCUTS_NODUAL:
             case MT_OPTCUTS:
             {
-                data_findExtrema = result;
+                if (snapshotFindExtrema)
+                {
+                    data_findExtrema = result;  // potentially time-consuming
+                }
                 switch (propType)
                 {
                     case 0:  // initiation
@@ -552,7 +640,8 @@ namespace OptCuts
                 assert(0 && "Fracture forbiddened for current method type!");
                 break;
         }
-        timer.stop();
+        context.timer.stop();
+        stateGen++;
 
         if (changed)
         {
@@ -564,9 +653,9 @@ namespace OptCuts
                 scaffold.mergeFixedV(result.fixedVert, fixedV_withScaf);
             }
 
-            timer.start(3);
+            context.timer.start(3);
             updateEnergyData(true, false, true);
-            timer.stop();
+            context.timer.stop();
             fractureInitiated = true;
             if ((!mute) && (propType == 0))
             {
@@ -578,6 +667,16 @@ namespace OptCuts
                 propagateFracture = 1 + isMerge;
             }
         }
+        if ((!mute) && context.metricsSink.isOpen())
+        {
+            if (context.methodType == MT_EBCUTS)
+            {
+                result.lastTopoOpType = -1;
+                result.lastTopoOpPath.resize(0);
+            }
+            writeTopologyMetrics(result.lastTopoOpType, changed, result.lastTopoOpPath,
+                                 (result.lastTopoOpType >= 0) ? result.lastTopoOpEwDec : 0.0, context.timer.timing(0) - topoTime0);
+        }
         return changed;
     }
 
@@ -606,43 +705,49 @@ namespace OptCuts
                 {
                     if (scaffolding)
                     {
+                        OPTCUTS_PROFILE_ZONE("matrixAssembly");
                         if (!mute)
                         {
-                            timer_step.start(1);
+                            context.timer_step.start(1);
                         }
-                        linSysSolver->set_pattern(scaffolding ? vNeighbor_withScaf : result.vNeighbor,
-                                                  scaffolding ? fixedV_withScaf : result.fixedVert);
+                        setLinSysPattern();
                         linSysSolver->update_a(I_mtr, J_mtr, V_mtr);
                         if (!mute)
                         {
-                            timer_step.stop();
-                            timer_step.start(2);
+                            context.timer_step.stop();
+                            context.timer_step.start(2);
+                        }
+                        if (linSysSolver->isPatternChanged())
+                        {
+                            OPTCUTS_PROFILE_ZONE("symbolicFactorization");
+                            linSysSolver->analyze_pattern();
                         }
-                        linSysSolver->analyze_pattern();
                         if (!mute)
                         {
-                            timer_step.stop();
+                            context.timer_step.stop();
                         }
                     }
                     else
                     {
+                        OPTCUTS_PROFILE_ZONE("matrixAssembly");
                         if (!mute)
                         {
-                            timer_step.start(1);
+                            context.timer_step.start(1);
                         }
                         linSysSolver->update_a(I_mtr, J_mtr, V_mtr);
                         if (!mute)
                         {
-                            timer_step.stop();
+                            context.timer_step.stop();
                         }
                     }
                 }
             }
             try
             {
+                OPTCUTS_PROFILE_ZONE("numericalFactorization");
                 if (!mute)
                 {
-                    timer_step.start(3);
+                    context.timer_step.start(3);
                 }
                 if (useDense)
                 {
@@ -654,14 +759,14 @@ namespace OptCuts
                 }
                 if (!mute)
                 {
-                    timer_step.stop();
+                    context.timer_step.stop();
                 }
             }
             catch (std::exception e)
             {
                 if (!useDense)
                 {
-                    IglUtils::writeSparseMatrixToFile(outputFolderPath + "mtr", I_mtr, J_mtr, V_mtr, true);
+                    IglUtils::writeSparseMatrixToFile(context.outputFolderPath + "mtr", I_mtr, J_mtr, V_mtr, true);
                 }
                 exit(-1);
             }
@@ -670,37 +775,79 @@ namespace OptCuts
         Eigen::VectorXd minusG = -gradient;
         if (!mute)
         {
-            timer_step.start(4);
-        }
-        if (useDense)
-        {
-            searchDir = denseSolver.solve(minusG);
+            context.timer_step.start(4);
         }
-        else
         {
-            linSysSolver->solve(minusG, searchDir);
+            OPTCUTS_PROFILE_ZONE("backSolve");
+            if (useDense)
+            {
+                searchDir = denseSolver.solve(minusG);
+            }
+            else
+            {
+                linSysSolver->solve(minusG, searchDir);
+            }
         }
         if (!mute)
         {
-            timer_step.stop();
+            context.timer_step.stop();
         }
 
         fractureInitiated = false;
 
         if (!mute)
         {
-            timer_step.start(5);
+            context.timer_step.start(5);
         }
         bool stopped = lineSearch();
         if (!mute)
         {
-            timer_step.stop();
+            context.timer_step.stop();
         }
         return stopped;
     }
 
+    // backtracking step size from interpolating the energy along searchDir:
+    // quadratic with E(0), E'(0) and the last trial, cubic once two trials are available,
+    // safeguarded to [0.1, 0.5] times the last trial, halving if E'(0) is not usable
+    static double interpolateStepSize(double E0, double dirDeriv, double stepSize, double E,
+                                      double stepSize_prev, double E_prev)
+    {
+        double stepSize_next = 0.5 * stepSize;
+        if (dirDeriv < 0.0)
+        {
+            if (stepSize_prev == 0.0)
+            {
+                stepSize_next = -dirDeriv * stepSize * stepSize / (2.0 * (E - E0 - dirDeriv * stepSize));
+            }
+            else
+            {
+                const double d1 = E - E0 - dirDeriv * stepSize;
+                const double d2 = E_prev - E0 - dirDeriv * stepSize_prev;
+                const double sqStep = stepSize * stepSize, sqStep_prev = stepSize_prev * stepSize_prev;
+                const double denom = sqStep * sqStep_prev * (stepSize - stepSize_prev);
+                const double a = (sqStep_prev * d1 - sqStep * d2) / denom;
+                const double b = (-sqStep_prev * stepSize_prev * d1 + sqStep * stepSize * d2) / denom;
+                if (std::abs(a) < 1.0e-12 * std::abs(b))
+                {
+                    stepSize_next = -dirDeriv / (2.0 * b);
+                }
+                else
+                {
+                    stepSize_next = (-b + std::sqrt(b * b - 3.0 * a * dirDeriv)) / (3.0 * a);
+                }
+            }
+            if (!std::isfinite(stepSize_next))
+            {
+                stepSize_next = 0.5 * stepSize;
+            }
+        }
+        return std::max(0.1 * stepSize, std::min(0.5 * stepSize, stepSize_next));
+    }
+
     bool Optimizer::lineSearch(void)
     {
+        OPTCUTS_PROFILE_ZONE("lineSearch");
         bool stopped = false;
         double stepSize = 1.0;
         initStepSize(result, stepSize);
@@ -711,33 +858,42 @@ namespace OptCuts
         }
 
         double lastEnergyVal_scaffold = 0.0;
-        Eigen::MatrixXd resultV0 = result.V;
-        Eigen::MatrixXd scaffoldV0;
+        resultV0_lineSearch = result.V;
         if (scaffolding)
         {
-            scaffoldV0 = scaffold.airMesh.V;
+            scaffoldV0_lineSearch = scaffold.airMesh.V;
             computeEnergyVal(result, scaffold, lastEnergyVal);  // this update is necessary since scaffold changes
             lastEnergyVal_scaffold = energyVal_scaffold;
         }
-        stepForward(resultV0, scaffoldV0, result, scaffold, stepSize);
+        stepForward(resultV0_lineSearch, scaffoldV0_lineSearch, result, scaffold, stepSize);
         double testingE;
         computeEnergyVal(result, scaffold, testingE);
-
-        while (testingE > lastEnergyVal)  // ensure energy decrease
-        {
-            stepSize /= 2.0;
+        int trialAmt = 1;
+
+        // Armijo condition, reduced to plain energy decrease if searchDir is not a descent direction
+        const double armijoCoef = 1.0e-4;
+        const double dirDeriv = std::min(0.0, gradient.dot(searchDir));
+        double stepSize_prev = 0.0, testingE_prev = lastEnergyVal;
+        while (!(testingE <= lastEnergyVal + armijoCoef * stepSize * dirDeriv))  // ensure energy decrease
+        {
+            const double stepSize_next = interpolateStepSize(lastEnergyVal, dirDeriv, stepSize, testingE,
+                                                             stepSize_prev, testingE_prev);
+            stepSize_prev = stepSize;
+            testingE_prev = testingE;
+            stepSize = stepSize_next;
             if (stepSize == 0.0)
             {
                 stopped = true;
                 if (!mute)
                 {
-                    logFile << "testingE" << globalIterNum << " " << testingE << " > " << lastEnergyVal << std::endl;
+                    context.logFile << "testingE" << globalIterNum << " " << testingE << " > " << lastEnergyVal << "\n";
                 }
                 break;
             }
 
-            stepForward(resultV0, scaffoldV0, result, scaffold, stepSize);
+            stepForward(resultV0_lineSearch, scaffoldV0_lineSearch, result, scaffold, stepSize);
             computeEnergyVal(result, scaffold, testingE);
+            trialAmt++;
         }
         if (!mute)
         {
@@ -756,9 +912,14 @@ namespace OptCuts
                 break;
             }
 
-            stepForward(resultV0, scaffoldV0, result, scaffold, stepSize);
+            stepForward(resultV0_lineSearch, scaffoldV0_lineSearch, result, scaffold, stepSize);
             computeEnergyVal(result, scaffold, testingE);
+            trialAmt++;
         }
+        lineSearchTrialAmt += trialAmt;
+        lineSearchAmt++;
+        lastLineSearchTrialAmt = trialAmt;
+        lastStepSize = stepSize;
 
         lastEDec = lastEnergyVal - testingE;
         if (scaffolding)
@@ -787,8 +948,13 @@ namespace OptCuts
     }
 
     void Optimizer::stepForward(const Eigen::MatrixXd& dataV0, const Eigen::MatrixXd& scaffoldV0, TriMesh& data, Scaffold& scaffoldData,
-                                double stepSize) const
+                                double stepSize)
     {
+        if ((&data == &result) || (&scaffoldData == &scaffold))
+        {
+            stateGen++;
+        }
+
         assert(dataV0.rows() == data.V.rows());
         if (scaffolding)
         {
@@ -846,13 +1012,25 @@ namespace OptCuts
         }
     }
 
+    double Optimizer::computeE_se(void)
+    {
+        if (seamSparsityGen == stateGen)
+        {
+            seamSparsityCacheHit++;
+        }
+        else
+        {
+            result.computeSeamSparsity(seamSparsity, !context.fractureMode);
+            seamSparsityGen = stateGen;
+        }
+        return seamSparsity / result.virtualRadius;
+    }
+
     void Optimizer::writeEnergyValToFile(bool flush)
     {
-        double E_se;
-        result.computeSeamSparsity(E_se, !fractureMode);
-        E_se /= result.virtualRadius;
+        const double E_se = computeE_se();
 
-        if (fractureMode)
+        if (context.fractureMode)
         {
             buffer_energyValPerIter << lastEnergyVal + (1.0 - energyParams[0]) * E_se;
         }
@@ -866,13 +1044,54 @@ namespace OptCuts
             buffer_energyValPerIter << " " << energyVal_ET[eI];
         }
 
-        buffer_energyValPerIter << " " << E_se << " " << energyParams[0] << "\n";
+        buffer_energyValPerIter << " " << E_se << " " << energyParams[0] << " " << lastLineSearchTrialAmt << "\n";
+        lastLineSearchTrialAmt = 0;  // for iterations without line search
 
         if (flush)
         {
             flushEnergyFileOutput();
         }
     }
+    void Optimizer::addMetricsState(MetricsRecord& record)
+    {
+        const double E_se = computeE_se();
+        record.add("iter", globalIterNum).add("topoIter", topoIter);
+        record.add("E", context.fractureMode ? (lastEnergyVal + (1.0 - energyParams[0]) * E_se) : lastEnergyVal);
+        record.add("E_terms", energyVal_ET);
+        if (scaffolding)
+        {
+            record.add("E_scaffold", energyVal_scaffold);
+        }
+        record.add("E_se", E_se).add("lambda", 1.0 - energyParams[0]);
+        record.add("vertAmt", static_cast<int>(result.V.rows())).add("seamAmt", static_cast<int>(result.cohE.rows()));
+    }
+
+    void Optimizer::writeNewtonMetrics(double sqn_g, bool stopped, const std::vector<double>& stepTimings0, int trialAmt)
+    {
+        MetricsRecord record("newton");
+        addMetricsState(record);
+        record.add("gradSqNorm", sqn_g).add("stepSize", lastStepSize).add("lsTrials", trialAmt).add("stopped", stopped);
+
+        // seconds spent in this iteration, in the order of the activities of timer_step
+        static const char* stepNames[] = {"t_mtrComp", "t_mtrAssem", "t_symFac", "t_numFac", "t_backSolve", "t_lineSearch"};
+        const std::vector<double>& stepTimings = context.timer_step.timings();
+        for (int stepI = 0; (stepI < 6) && (stepI < stepTimings.size()) && (stepI < stepTimings0.size()); stepI++)
+        {
+            record.add(stepNames[stepI], stepTimings[stepI] - stepTimings0[stepI]);
+        }
+        context.metricsSink.emit(record);
+    }
+
+    void Optimizer::writeTopologyMetrics(int opType, bool changed, const std::vector<int>& path, double EwDec, double seconds)
+    {
+        MetricsRecord record("topology");
+        addMetricsState(record);
+        static const char* opNames[] = {"boundarySplit", "interiorSplit", "merge"};
+        record.add("op", ((opType >= 0) && (opType < 3)) ? opNames[opType] : "none").add("changed", changed);
+        record.add("path", path).add("EwDec", EwDec).add("t_topology", seconds);
+        context.metricsSink.emit(record);
+    }
+
     void Optimizer::writeGradL2NormToFile(bool flush)
     {
         buffer_gradientPerIter << gradient.squaredNorm();
@@ -889,14 +1108,13 @@ namespace OptCuts
     }
     void Optimizer::flushEnergyFileOutput(void)
     {
-        file_energyValPerIter << buffer_energyValPerIter.str();
-        file_energyValPerIter.flush();
+        // handed to the writer thread
+        file_energyValPerIter.write(buffer_energyValPerIter.str());
         clearEnergyFileOutputBuffer();
     }
     void Optimizer::flushGradFileOutput(void)
     {
-        file_gradientPerIter << buffer_gradientPerIter.str();
-        file_gradientPerIter.flush();
+        file_gradientPerIter.write(buffer_gradientPerIter.str());
         clearGradFileOutputBuffer();
     }
     void Optimizer::clearEnergyFileOutputBuffer(void)
@@ -912,19 +1130,35 @@ namespace OptCuts
 
     void Optimizer::computeEnergyVal(const TriMesh& data, const Scaffold& scaffoldData, double& energyVal, bool excludeScaffold)
     {
-        energyTerms[0]->computeEnergyVal(data, energyVal_ET[0]);
+        const bool isResult = (&data == &result);
+        if (isResult && (energyValGen == stateGen))
+        {
+            energyValCacheHit++;
+        }
+        else
+        {
+            for (int eI = 0; eI < energyTerms.size(); eI++)
+            {
+                energyTerms[eI]->computeEnergyVal(data, energyVal_ET[eI]);
+            }
+            energyValGen = (isResult ? stateGen : 0);
+        }
         energyVal = energyParams[0] * energyVal_ET[0];
         for (int eI = 1; eI < energyTerms.size(); eI++)
         {
-            energyTerms[eI]->computeEnergyVal(data, energyVal_ET[eI]);
             energyVal += energyParams[eI] * energyVal_ET[eI];
         }
 
         if (scaffolding && (!excludeScaffold))
         {
-            SymDirichletEnergy SD;
-            SD.computeEnergyVal(scaffoldData.airMesh, energyVal_scaffold, true);
-            energyVal_scaffold *= w_scaf / scaffold.airMesh.F.rows();
+            const bool isScaffold = (&scaffoldData == &scaffold);
+            if (!(isScaffold && (energyValGen_scaffold == stateGen)))
+            {
+                SymDirichletEnergy SD;
+                SD.computeEnergyVal(scaffoldData.airMesh, energyValUnweighted_scaffold, true);
+                energyValGen_scaffold = (isScaffold ? stateGen : 0);
+            }
+            energyVal_scaffold = energyValUnweighted_scaffold * w_scaf / scaffold.airMesh.F.rows();
             energyVal += energyVal_scaffold;
         }
         else
@@ -934,26 +1168,41 @@ namespace OptCuts
     }
     void Optimizer::computeGradient(const TriMesh& data, const Scaffold& scaffoldData, Eigen::VectorXd& gradient, bool excludeScaffold)
     {
-        energyTerms[0]->computeGradient(data, gradient_ET[0]);
+        const bool isResult = ((&data == &result) && ((!scaffolding) || (&scaffoldData == &scaffold)));
+        if (isResult && (gradientGen == stateGen))
+        {
+            gradientCacheHit++;
+        }
+        else
+        {
+            for (int eI = 0; eI < energyTerms.size(); eI++)
+            {
+                energyTerms[eI]->computeGradient(data, gradient_ET[eI]);
+            }
+            if (scaffolding)
+            {
+                SymDirichletEnergy SD;
+                SD.computeGradient(scaffoldData.airMesh, gradient_scaffold, true);
+            }
+            gradientGen = (isResult ? stateGen : 0);
+        }
         gradient = energyParams[0] * gradient_ET[0];
         for (int eI = 1; eI < energyTerms.size(); eI++)
         {
-            energyTerms[eI]->computeGradient(data, gradient_ET[eI]);
             gradient += energyParams[eI] * gradient_ET[eI];
         }
 
         if (scaffolding)
         {
-            SymDirichletEnergy SD;
-            SD.computeGradient(scaffoldData.airMesh, gradient_scaffold, true);
             scaffoldData.augmentGradient(gradient, gradient_scaffold, (excludeScaffold ? 0.0 : (w_scaf / scaffold.airMesh.F.rows())));
         }
     }
     void Optimizer::computeHessian(const TriMesh& data, const Scaffold& scaffoldData)
     {
+        OPTCUTS_PROFILE_ZONE("computeHessian");
         if (!mute)
         {
-            timer_step.start(0);
+            context.timer_step.start(0);
         }
         if (useDense)
         {
@@ -1004,7 +1253,7 @@ namespace OptCuts
         }
         if (!mute)
         {
-            timer_step.stop();
+            context.timer_step.stop();
         }
     }
 
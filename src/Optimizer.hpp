@@ -13,6 +13,8 @@
 #include "Scaffold.hpp"
 
 #include "LinSysSolver.hpp"
+#include "RunContext.hpp"
+#include "AsyncFileWriter.hpp"
 
 #include <fstream>
 
@@ -23,6 +25,7 @@ namespace OptCuts {
         friend class TriMesh;
         
     protected: // referenced data
+        RunContext& context; // log, timers, output folder and query results of the run
         const TriMesh& data0; // initial guess
         const std::vector<Energy*>& energyTerms; // E_0, E_1, E_2, ...
         const std::vector<double>& energyParams; // a_0, a_1, a_2, ...
@@ -32,6 +35,7 @@ namespace OptCuts {
         bool useDense = false;
         int propagateFracture;
         bool fractureInitiated = false;
+        bool lastPropagate = false; // whether the last topology step in solve() propagated a fracture
         bool allowEDecRelTol;
         bool mute;
         bool pardisoThreadAmt;
@@ -41,9 +45,12 @@ namespace OptCuts {
         double relGL2Tol, energyParamSum;
         TriMesh result; // intermediate results of each iteration
         TriMesh data_findExtrema; // intermediate results for deciding the cuts in each topology step
+        bool snapshotFindExtrema; // whether to copy result into data_findExtrema before each topology step
         bool scaffolding; // whether to enable bijectivity parameterization
         double w_scaf;
         Scaffold scaffold; // air meshes to enforce bijectivity
+        bool incrementalScaffold; // whether to maintain the air mesh incrementally between topology changes, off by default
+        double scaffoldQualityThres; // air mesh triangles below this quality get retriangulated
         Eigen::VectorXi I_mtr, J_mtr; // triplet representation
         Eigen::VectorXd V_mtr;
         Eigen::MatrixXd Hessian; // when using dense representation
@@ -53,6 +60,10 @@ namespace OptCuts {
         Eigen::VectorXd gradient; // energy gradient computed in each iteration
         Eigen::VectorXd searchDir; // search direction comptued in each iteration
         double lastEnergyVal; // for output and line search
+        Eigen::MatrixXd resultV0_lineSearch, scaffoldV0_lineSearch; // reused start positions of line search
+        int lineSearchTrialAmt, lineSearchAmt; // energy evaluations and calls of line search
+        int lastLineSearchTrialAmt; // energy evaluations of the line search in the current iteration
+        double lastStepSize; // accepted by the last line search
         double lastEDec;
         double targetGRes;
         std::vector<Eigen::VectorXd> gradient_ET;
@@ -60,19 +71,30 @@ namespace OptCuts {
         std::vector<double> energyVal_ET;
         double energyVal_scaffold;
         
+        // versioned evaluation cache: stateGen advances whenever result or scaffold changes
+        // through this class, and the quantities computed on result are reused until then,
+        // values are cached per term so that changes of the energy parameters are still reflected
+        unsigned long stateGen;
+        unsigned long energyValGen, energyValGen_scaffold, gradientGen, seamSparsityGen;
+        double energyValUnweighted_scaffold; // before multiplying w_scaf / airMesh.F.rows()
+        double seamSparsity;
+        int energyValCacheHit, gradientCacheHit, seamSparsityCacheHit;
+        
         Eigen::MatrixXd UV_bnds_scaffold;
         Eigen::MatrixXi E_scaffold;
         Eigen::VectorXi bnd_scaffold;
-        std::vector<std::set<int>> vNeighbor_withScaf;
-        std::set<int> fixedV_withScaf;
+        VertexAdjacency vNeighbor_withScaf;
+        std::vector<bool> fixedV_withScaf;
+        VertexAdjacency vNeighbor_linSys; // of result when not scaffolding
         
         std::ostringstream buffer_energyValPerIter;
         std::ostringstream buffer_gradientPerIter;
-        std::ofstream file_energyValPerIter;
-        std::ofstream file_gradientPerIter;
+        AsyncFileWriter file_energyValPerIter;
+        AsyncFileWriter file_gradientPerIter;
         
     public: // constructor and destructor
-        Optimizer(const TriMesh& p_data0, const std::vector<Energy*>& p_energyTerms, const std::vector<double>& p_energyParams,
+        Optimizer(RunContext& p_context, const TriMesh& p_data0,
+                  const std::vector<Energy*>& p_energyTerms, const std::vector<double>& p_energyParams,
                   int p_propagateFracture = 1, bool p_mute = false, bool p_scaffolding = false,
                   const Eigen::MatrixXd& UV_bnds = Eigen::MatrixXd(),
                   const Eigen::MatrixXi& E = Eigen::MatrixXi(),
@@ -95,7 +117,8 @@ namespace OptCuts {
                             bool allowPropagate = true, bool allowInSplit = false);
         bool createFracture(int opType, const std::vector<int>& path, const Eigen::MatrixXd& newVertPos, bool allowPropagate);
         void setConfig(const TriMesh& config, int iterNum, int p_topoIter);
-        void setPropagateFracture(bool p_prop);
+        // 0: off, 1: propagate split, 2: propagate merge
+        void setPropagateFracture(int p_prop);
         void setScaffolding(bool p_scaffolding);
         void setUseDense(bool p_useDense = true);
         
@@ -109,8 +132,17 @@ namespace OptCuts {
         const TriMesh& getData_findExtrema(void) const;
         int getIterNum(void) const;
         int getTopoIter(void) const;
+        int getPropagateFracture(void) const;
+        double getAvgLineSearchTrialAmt(void) const;
+        void getEvalCacheHits(int& energyValHit, int& gradientHit, int& seamSparsityHit) const;
         void setRelGL2Tol(double p_relTol);
         void setAllowEDecRelTol(bool p_allowEDecRelTol);
+        // data_findExtrema is only needed for visualization (and set by MT_EBCUTS itself),
+        // turn off to skip the full mesh copy in each topology step
+        void setSnapshotFindExtrema(bool p_snapshotFindExtrema);
+        // reconstructing the air mesh after each iteration is the reference behavior,
+        // the incremental mode only retriangulates low quality cells
+        void setIncrementalScaffold(bool p_incrementalScaffold, double p_qualityThres = 0.2);
         
         void flushEnergyFileOutput(void);
         void flushGradFileOutput(void);
@@ -123,9 +155,15 @@ namespace OptCuts {
         bool solve_oneStep(void);
         
         bool lineSearch(void);
+        
+        // reconstruct or incrementally update the air mesh after an iteration without topology change
+        void maintainScaffold(void);
+        
+        // set the pattern of linSysSolver from the vertex adjacency of result (with the air mesh if scaffolding)
+        void setLinSysPattern(void);
 
         void stepForward(const Eigen::MatrixXd& dataV0, const Eigen::MatrixXd& scaffoldV0,
-                         TriMesh& data, Scaffold& scaffoldData, double stepSize) const;
+                         TriMesh& data, Scaffold& scaffoldData, double stepSize);
         
         void updateTargetGRes(void);
         
@@ -135,9 +173,17 @@ namespace OptCuts {
         
         void initStepSize(const TriMesh& data, double& stepSize) const;
         
+        // seam sparsity of result normalized by virtualRadius, cached per state
+        double computeE_se(void);
+        
         void writeEnergyValToFile(bool flush);
         void writeGradL2NormToFile(bool flush);
         
+        // structured records for metricsSink, only called when not muted
+        void addMetricsState(MetricsRecord& record);
+        void writeNewtonMetrics(double sqn_g, bool stopped, const std::vector<double>& stepTimings0, int trialAmt);
+        void writeTopologyMetrics(int opType, bool changed, const std::vector<int>& path, double EwDec, double seconds);
+        
     public: // data access
         double getLastEnergyVal(bool excludeScaffold = false) const;
     };
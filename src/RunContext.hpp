@@ -0,0 +1,48 @@
+//
+//  RunContext.hpp
+//  OptCuts
+//
+
+#ifndef RunContext_hpp
+#define RunContext_hpp
+
+#include "Types.hpp"
+#include "CandidateBudget.hpp"
+#include "MetricsSink.hpp"
+#include "Timer.hpp"
+
+#include <Eigen/Eigen>
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OptCuts {
+
+    // the state of one optimization run that the Optimizer and the meshes it works on
+    // share with the driver, so that several runs can live in one process,
+    // TriMesh::context points to it for the meshes owned by an Optimizer
+    class RunContext {
+    public:
+        MethodType methodType = MT_OPTCUTS;
+        bool fractureMode = false;
+        std::string outputFolderPath; // ends with '/'
+
+        std::ofstream logFile;
+        MetricsSink metricsSink;
+        Timer timer, timer_step;
+
+        // candidates of the last topology query for the dual update:
+        // (E_SD, E_se) changes, paths and new vertex positions
+        std::vector<std::pair<double, double>> energyChanges_bSplit, energyChanges_iSplit, energyChanges_merge;
+        std::vector<std::vector<int>> paths_bSplit, paths_iSplit, paths_merge;
+        std::vector<Eigen::MatrixXd> newVertPoses_bSplit, newVertPoses_iSplit, newVertPoses_merge;
+        double filterExp_in = 0.6;
+        int inSplitTotalAmt = 0;
+        CandidateBudget bSplitCandBudget = CandidateBudget(0.8); // for boundary split queries
+    };
+
+}
+
+#endif /* RunContext_hpp */
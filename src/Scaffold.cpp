@@ -7,8 +7,9 @@
 
 #include "Scaffold.hpp"
 #include "IglUtils.hpp"
+#include "Profiler.hpp"
+#include "RunContext.hpp"
 #include "SymDirichletEnergy.hpp"
-#include "Timer.hpp"
 
 #include <igl/triangle/triangulate.h>
 #include <igl/boundary_loop.h>
@@ -17,9 +18,24 @@
 
 #include <tbb/tbb.h>
 
-extern Timer timer;
+#include <algorithm>
+#include <iterator>
+#include <mutex>
 
 namespace OptCuts {
+    // Triangle keeps its error bounds and the random seed of point location in globals,
+    // so the calls from concurrent local solves are serialized
+    static std::mutex triangleMutex;
+    static void triangulate(const Eigen::MatrixXd& V, const Eigen::MatrixXi& E, const Eigen::MatrixXd& H,
+                            Eigen::MatrixXd& V2, Eigen::MatrixXi& F2)
+    {
+        std::lock_guard<std::mutex> lock(triangleMutex);
+        // "Y" for no Steiner points on mesh boundary
+        // "q" for high quality mesh generation
+        // "Q" for quiet mode (no output)
+        igl::triangle::triangulate(V, E, H, "qYQ", V2, F2);
+    }
+    
     Scaffold::Scaffold(void)
     {
     }
@@ -27,14 +43,17 @@ namespace OptCuts {
     Scaffold::Scaffold(const TriMesh& mesh, Eigen::MatrixXd UV_bnds, Eigen::MatrixXi E, const Eigen::VectorXi& p_bnd)
     {
         assert(E.rows() == UV_bnds.rows());
+        OPTCUTS_PROFILE_ZONE("scaffoldConstruction");
 
         Eigen::MatrixXd H;
         bool fixAMBoundary = false;
         bool countTime = false;
         double edgeLen_eps = mesh.avgEdgeLen * 0.5; //NOTE: different from what's used in [Jiang et al. 2017]
         if(E.rows() == 0) {
-            countTime = true;
-            timer.start(2);
+            countTime = (mesh.context != NULL);
+            if(countTime) {
+                mesh.context->timer.start(2);
+            }
             std::vector<std::vector<int>> bnd_all;
             igl::boundary_loop(mesh.F, bnd_all);
             assert(bnd_all.size());
@@ -166,10 +185,7 @@ namespace OptCuts {
             // so no processing for H
         }
         
-        igl::triangle::triangulate(UV_bnds, E, H, "qYQ", airMesh.V, airMesh.F);
-        // "Y" for no Steiner points on mesh boundary
-        // "q" for high quality mesh generation
-        // "Q" for quiet mode (no output)
+        triangulate(UV_bnds, E, H, airMesh.V, airMesh.F);
         
         airMesh.V_rest.resize(airMesh.V.rows(), 3);
         airMesh.V_rest << airMesh.V, Eigen::VectorXd::Zero(airMesh.V.rows());
@@ -197,9 +213,10 @@ namespace OptCuts {
                 airMesh.fixedVert.insert(vI);
             }
         }
+        airMesh.updateFixedVertMask();
         
         if(countTime) {
-            timer.stop();
+            mesh.context->timer.stop();
         }
         
         // add bijectivity to optimization on local stencil: interior split?
@@ -207,6 +224,214 @@ namespace OptCuts {
         // fix bounding box?
     }
     
+    bool Scaffold::update(const TriMesh& mesh, double qualityThres, bool& retriangulated)
+    {
+        OPTCUTS_PROFILE_ZONE("scaffoldUpdate");
+        retriangulated = false;
+        const int bndVAmt = static_cast<int>(bnd.size());
+        if((bndVAmt == 0) || (mesh.V.rows() + airMesh.V.rows() - bndVAmt != wholeMeshSize)) {
+            return false;
+        }
+        
+        // only maintained incrementally for the result of an Optimizer
+        assert(mesh.context);
+        Timer& timer = mesh.context->timer;
+        timer.start(2);
+        
+        // the air mesh follows the mesh during line search,
+        // sync the shared boundary to avoid drifting apart by round-off
+        for(int vI = 0; vI < bndVAmt; vI++) {
+            airMesh.V.row(vI) = mesh.V.row(bnd[vI]);
+        }
+        
+        // measure triangle quality 4 * sqrt(3) * area / (sum of squared edge lengths),
+        // 1 for equilateral triangles and non-positive for inverted ones
+        std::vector<char> isBadTri(airMesh.F.rows(), 0);
+        tbb::parallel_for(0, (int)airMesh.F.rows(), 1, [&](int triI) {
+            const Eigen::RowVector2d e0 = airMesh.V.row(airMesh.F(triI, 1)) - airMesh.V.row(airMesh.F(triI, 0));
+            const Eigen::RowVector2d e1 = airMesh.V.row(airMesh.F(triI, 2)) - airMesh.V.row(airMesh.F(triI, 1));
+            const Eigen::RowVector2d e2 = airMesh.V.row(airMesh.F(triI, 0)) - airMesh.V.row(airMesh.F(triI, 2));
+            const double area = 0.5 * (e0[0] * e1[1] - e0[1] * e1[0]);
+            const double quality = 4.0 * std::sqrt(3.0) * area / (e0.squaredNorm() + e1.squaredNorm() + e2.squaredNorm());
+            isBadTri[triI] = ((area < airMesh.areaThres_AM) || (quality < qualityThres));
+        });
+        
+        std::set<int> badVerts;
+        for(int triI = 0; triI < airMesh.F.rows(); triI++) {
+            if(isBadTri[triI]) {
+                badVerts.insert(airMesh.F(triI, 0));
+                badVerts.insert(airMesh.F(triI, 1));
+                badVerts.insert(airMesh.F(triI, 2));
+            }
+        }
+        
+        if(badVerts.empty()) {
+            // keep the tessellation and only take the current shape as rest shape
+            airMesh.V_rest.leftCols(2) = airMesh.V;
+            std::vector<Eigen::RowVector3d> vertNormals;
+            airMesh.computeRestShapeFeatures(vertNormals);
+            timer.stop();
+            return true;
+        }
+        
+        // the cells to retriangulate are all triangles incident to the vertices of bad ones
+        std::vector<char> inRegion(airMesh.F.rows(), 0);
+        for(int triI = 0; triI < airMesh.F.rows(); triI++) {
+            for(int vI = 0; vI < 3; vI++) {
+                if(badVerts.find(airMesh.F(triI, vI)) != badVerts.end()) {
+                    inRegion[triI] = 1;
+                    break;
+                }
+            }
+        }
+        
+        // split the region into edge-connected components,
+        // each should be a topological disk bounded by a single loop
+        std::vector<int> compI_tri(airMesh.F.rows(), -1);
+        std::vector<std::vector<int>> bndLoops;
+        std::set<int> regionVerts;
+        for(int seedTriI = 0; seedTriI < airMesh.F.rows(); seedTriI++) {
+            if((!inRegion[seedTriI]) || (compI_tri[seedTriI] >= 0)) {
+                continue;
+            }
+            
+            const int compI = static_cast<int>(bndLoops.size());
+            std::map<int, int> nextBndV;
+            std::vector<int> triStack(1, seedTriI);
+            compI_tri[seedTriI] = compI;
+            while(!triStack.empty()) {
+                const int triI = triStack.back();
+                triStack.pop_back();
+                for(int vI = 0; vI < 3; vI++) {
+                    const int vI0 = airMesh.F(triI, vI), vI1 = airMesh.F(triI, (vI + 1) % 3);
+                    regionVerts.insert(vI0);
+                    const auto twinFinder = airMesh.edge2Tri.find(std::pair<int, int>(vI1, vI0));
+                    if((twinFinder != airMesh.edge2Tri.end()) && inRegion[twinFinder->second]) {
+                        if(compI_tri[twinFinder->second] < 0) {
+                            compI_tri[twinFinder->second] = compI;
+                            triStack.push_back(twinFinder->second);
+                        }
+                    }
+                    else if(!nextBndV.insert(std::pair<int, int>(vI0, vI1)).second) {
+                        // pinched boundary
+                        timer.stop();
+                        return false;
+                    }
+                }
+            }
+            
+            bndLoops.resize(compI + 1);
+            const int startVI = nextBndV.begin()->first;
+            auto nextFinder = nextBndV.begin();
+            do {
+                bndLoops[compI].push_back(nextFinder->first);
+                nextFinder = nextBndV.find(nextFinder->second);
+            } while((nextFinder != nextBndV.end()) && (nextFinder->first != startVI) &&
+                    (bndLoops[compI].size() < nextBndV.size()));
+            if((nextFinder == nextBndV.end()) || (nextFinder->first != startVI) ||
+               (bndLoops[compI].size() != nextBndV.size())) {
+                // multiple boundary loops (the region surrounds a chart or other air cells)
+                timer.stop();
+                return false;
+            }
+        }
+        
+        // retriangulate each component with its boundary fixed
+        std::vector<Eigen::MatrixXd> V_loc(bndLoops.size());
+        std::vector<Eigen::MatrixXi> F_loc(bndLoops.size());
+        for(int compI = 0; compI < bndLoops.size(); compI++) {
+            const std::vector<int>& loop = bndLoops[compI];
+            Eigen::MatrixXd UV_loop(loop.size(), 2);
+            Eigen::MatrixXi E_loop(loop.size(), 2);
+            for(int loopVI = 0; loopVI < loop.size(); loopVI++) {
+                UV_loop.row(loopVI) = airMesh.V.row(loop[loopVI]);
+                E_loop.row(loopVI) << loopVI, static_cast<int>((loopVI + 1) % loop.size());
+            }
+            triangulate(UV_loop, E_loop, Eigen::MatrixXd(), V_loc[compI], F_loc[compI]);
+            if((V_loc[compI].rows() < UV_loop.rows()) ||
+               !V_loc[compI].topRows(UV_loop.rows()).isApprox(UV_loop)) {
+                // input vertices are expected to come first in the output
+                timer.stop();
+                return false;
+            }
+        }
+        
+        // drop the vertices strictly inside the region and compact the rest,
+        // vertices on the mesh boundary and the bounding box are always on a loop
+        std::vector<int> oldVI2New(airMesh.V.rows(), 0);
+        for(const auto& loop : bndLoops) {
+            for(const auto& vI : loop) {
+                regionVerts.erase(vI);
+            }
+        }
+        for(const auto& vI : regionVerts) {
+            assert(vI >= bndVAmt);
+            oldVI2New[vI] = -1;
+        }
+        int newVAmt = 0;
+        for(int vI = 0; vI < airMesh.V.rows(); vI++) {
+            if(oldVI2New[vI] == 0) {
+                oldVI2New[vI] = newVAmt++;
+            }
+        }
+        
+        int steinerVAmt = 0, newTriAmt = 0;
+        for(int compI = 0; compI < bndLoops.size(); compI++) {
+            steinerVAmt += V_loc[compI].rows() - bndLoops[compI].size();
+            newTriAmt += F_loc[compI].rows();
+        }
+        for(int triI = 0; triI < airMesh.F.rows(); triI++) {
+            newTriAmt += !inRegion[triI];
+        }
+        
+        Eigen::MatrixXd newV(newVAmt + steinerVAmt, 2);
+        for(int vI = 0; vI < airMesh.V.rows(); vI++) {
+            if(oldVI2New[vI] >= 0) {
+                newV.row(oldVI2New[vI]) = airMesh.V.row(vI);
+            }
+        }
+        Eigen::MatrixXi newF(newTriAmt, 3);
+        int triAmt = 0;
+        for(int triI = 0; triI < airMesh.F.rows(); triI++) {
+            if(!inRegion[triI]) {
+                newF.row(triAmt++) << oldVI2New[airMesh.F(triI, 0)],
+                    oldVI2New[airMesh.F(triI, 1)], oldVI2New[airMesh.F(triI, 2)];
+            }
+        }
+        for(int compI = 0; compI < bndLoops.size(); compI++) {
+            const std::vector<int>& loop = bndLoops[compI];
+            std::vector<int> localVI2New(V_loc[compI].rows());
+            for(int localVI = 0; localVI < loop.size(); localVI++) {
+                localVI2New[localVI] = oldVI2New[loop[localVI]];
+            }
+            for(int localVI = loop.size(); localVI < V_loc[compI].rows(); localVI++) {
+                localVI2New[localVI] = newVAmt;
+                newV.row(newVAmt++) = V_loc[compI].row(localVI);
+            }
+            for(int triI = 0; triI < F_loc[compI].rows(); triI++) {
+                newF.row(triAmt++) << localVI2New[F_loc[compI](triI, 0)],
+                    localVI2New[F_loc[compI](triI, 1)], localVI2New[F_loc[compI](triI, 2)];
+            }
+        }
+        
+        airMesh.V = newV;
+        airMesh.F = newF;
+        airMesh.V_rest.resize(airMesh.V.rows(), 3);
+        airMesh.V_rest << airMesh.V, Eigen::VectorXd::Zero(airMesh.V.rows());
+        airMesh.computeFeatures();
+        
+        // boundary vertices keep their indices, so meshVI2AirMesh and the fixed vertices stay valid
+        localVI2Global.conservativeResize(airMesh.V.rows());
+        for(int vI = bndVAmt; vI < airMesh.V.rows(); vI++) {
+            localVI2Global[vI] = mesh.V.rows() + vI - bndVAmt;
+        }
+        wholeMeshSize = mesh.V.rows() + airMesh.V.rows() - bndVAmt;
+        
+        retriangulated = true;
+        timer.stop();
+        return true;
+    }
+    
     void Scaffold::augmentGradient(Eigen::VectorXd& gradient, const Eigen::VectorXd& gradient_scaf, double w_scaf) const
     {
         assert(gradient.size() / 2 + airMesh.V.rows() - bnd.size() == wholeMeshSize);
@@ -292,23 +517,91 @@ namespace OptCuts {
         }
     }
     
-    void Scaffold::mergeVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, std::vector<std::set<int>>& vNeighbor) const
+    void Scaffold::mergeVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, VertexAdjacency& vNeighbor) const
+    {
+        VertexAdjacency merged;
+        mergeVNeighbor(vNeighbor_mesh, NULL, merged);
+        std::swap(vNeighbor, merged);
+    }
+    
+    void Scaffold::updateMergedVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, VertexAdjacency& vNeighbor) const
     {
-        vNeighbor = vNeighbor_mesh;
-        vNeighbor.resize(wholeMeshSize);
-        tbb::parallel_for(0, (int)airMesh.vNeighbor.size(), 1, [&](int scafVI) {
-            auto& neighbors = vNeighbor[localVI2Global[scafVI]];
+        assert(vNeighbor_mesh.size() + airMesh.V.rows() - bnd.size() == wholeMeshSize);
+        assert(vNeighbor.size() >= vNeighbor_mesh.size());
+        
+        VertexAdjacency merged;
+        mergeVNeighbor(vNeighbor_mesh, &vNeighbor, merged);
+        std::swap(vNeighbor, merged);
+    }
+    
+    void Scaffold::mergeVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, const VertexAdjacency* vNeighbor_kept,
+                                  VertexAdjacency& vNeighbor) const
+    {
+        const int meshSize = static_cast<int>(vNeighbor_mesh.size());
+        std::vector<int> meshVI2AirMeshVI(meshSize, -1);
+        for(int vI = 0; vI < bnd.size(); vI++) {
+            meshVI2AirMeshVI[bnd[vI]] = vI;
+        }
+        
+        // the neighbors of an air mesh vertex in augmented system indices, ascending
+        std::vector<int> nb_scaf, nb_merged;
+        const auto getAirMeshNeighbors = [&](int scafVI) {
+            nb_scaf.resize(0);
             for(const auto& nb_scafVI : airMesh.vNeighbor[scafVI]) {
-                neighbors.insert(localVI2Global[nb_scafVI]);
+                nb_scaf.emplace_back(localVI2Global[nb_scafVI]);
             }
-        });
+            std::sort(nb_scaf.begin(), nb_scaf.end());
+        };
+        
+        int nnz_scaf = 0;
+        for(const auto& nbI : airMesh.vNeighbor) {
+            nnz_scaf += static_cast<int>(nbI.size());
+        }
+        vNeighbor.reset((vNeighbor_kept ? vNeighbor_kept->nnz() : 0) + nnz_scaf);
+        for(int vI = 0; vI < meshSize; vI++) {
+            const int scafVI = meshVI2AirMeshVI[vI];
+            if(scafVI < 0) {
+                if(vNeighbor_kept) {
+                    for(const auto& nbVI : (*vNeighbor_kept)[vI]) {
+                        vNeighbor.push_back(nbVI);
+                    }
+                }
+                else {
+                    for(const auto& nbVI : vNeighbor_mesh[vI]) {
+                        vNeighbor.push_back(nbVI);
+                    }
+                }
+            }
+            else {
+                // boundary vertex, shared by both
+                getAirMeshNeighbors(scafVI);
+                nb_merged.resize(0);
+                std::set_union(vNeighbor_mesh[vI].begin(), vNeighbor_mesh[vI].end(), nb_scaf.begin(), nb_scaf.end(),
+                               std::back_inserter(nb_merged));
+                for(const auto& nbVI : nb_merged) {
+                    vNeighbor.push_back(nbVI);
+                }
+            }
+            vNeighbor.endRow();
+        }
+        for(int scafVI = bnd.size(); scafVI < airMesh.V.rows(); scafVI++) {
+            getAirMeshNeighbors(scafVI);
+            for(const auto& nbVI : nb_scaf) {
+                vNeighbor.push_back(nbVI);
+            }
+            vNeighbor.endRow();
+        }
+        assert(vNeighbor.size() == wholeMeshSize);
     }
     
-    void Scaffold::mergeFixedV(const std::set<int>& fixedV_mesh, std::set<int>& fixedV) const
+    void Scaffold::mergeFixedV(const std::set<int>& fixedV_mesh, std::vector<bool>& isFixedV) const
     {
-        fixedV = fixedV_mesh;
+        isFixedV.assign(wholeMeshSize, false);
+        for(const auto& fixedVI : fixedV_mesh) {
+            isFixedV[fixedVI] = true;
+        }
         for(const auto& fixedV_scafVI : airMesh.fixedVert) {
-            fixedV.insert(localVI2Global[fixedV_scafVI]);
+            isFixedV[localVI2Global[fixedV_scafVI]] = true;
         }
     }
     
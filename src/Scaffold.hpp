@@ -9,6 +9,7 @@
 #define Scaffold_hpp
 
 #include "TriMesh.hpp"
+#include "VertexAdjacency.hpp"
 
 #include<Eigen/Eigen>
 
@@ -28,6 +29,12 @@ namespace OptCuts {
         Scaffold(const TriMesh& mesh, Eigen::MatrixXd UV_bnds = Eigen::MatrixXd(),
                 Eigen::MatrixXi E = Eigen::MatrixXi(), const Eigen::VectorXi& p_bnd = Eigen::VectorXi());
 
+        // incrementally maintain the air mesh of the whole mesh after a geometry-only step:
+        // takes the current air mesh as rest shape and locally retriangulates the cells around
+        // air mesh triangles with quality below qualityThres,
+        // returns false if the scaffold needs to be reconstructed instead
+        bool update(const TriMesh& mesh, double qualityThres, bool& retriangulated);
+        
         // augment mesh gradient with air mesh gradient with parameter w_scaf
         void augmentGradient(Eigen::VectorXd& gradient, const Eigen::VectorXd& gradient_scaf, double w_scaf) const;
         
@@ -46,8 +53,13 @@ namespace OptCuts {
         // stepForward air mesh using augmented searchDir
         void stepForward(const Eigen::MatrixXd& V0, const Eigen::VectorXd& searchDir, double stepSize);
         
-        void mergeVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, std::vector<std::set<int>>& vNeighbor) const;
-        void mergeFixedV(const std::set<int>& fixedV_mesh, std::set<int>& fixedV) const;
+        // adjacency of the augmented system
+        void mergeVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, VertexAdjacency& vNeighbor) const;
+        // refresh a merged vNeighbor after only the air mesh changed,
+        // the rows of mesh interior vertices are kept
+        void updateMergedVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, VertexAdjacency& vNeighbor) const;
+        // fixed vertices of the augmented system as a bitset
+        void mergeFixedV(const std::set<int>& fixedV_mesh, std::vector<bool>& isFixedV) const;
         
         // for rendering purpose:
         void augmentUVwithAirMesh(Eigen::MatrixXd& UV, double scale) const;
@@ -61,6 +73,11 @@ namespace OptCuts {
         
         bool getCornerAirLoop(const std::vector<int>& corner_mesh, const Eigen::RowVector2d& mergedPos,
                               Eigen::MatrixXd& UV, Eigen::MatrixXi& E, Eigen::VectorXi& bnd) const;
+        
+    protected:
+        // rows of mesh interior vertices are copied from vNeighbor_kept if given
+        void mergeVNeighbor(const std::vector<std::set<int>>& vNeighbor_mesh, const VertexAdjacency* vNeighbor_kept,
+                            VertexAdjacency& vNeighbor) const;
     };
 }
 
@@ -0,0 +1,1658 @@
+//
+//  Session.cpp
+//  OptCuts
+//
+
+#include "Session.hpp"
+
+#include "BinaryIO.hpp"
+#include "IglUtils.hpp"
+#include "MeshIO.hpp"
+#include "Profiler.hpp"
+#include "SymDirichletEnergy.hpp"
+#include "cut_to_disk.hpp"  // hasn't been pulled into the older version of libigl we use
+
+#include <igl/boundary_loop.h>
+#include <igl/cut_mesh.h>
+#include <igl/edge_lengths.h>
+#include <igl/facet_components.h>
+#include <igl/is_edge_manifold.h>
+#include <igl/is_vertex_manifold.h>
+#include <igl/writeOBJ.h>
+#include <tbb/tbb.h>
+
+#include <sys/stat.h>  // for mkdir
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined _MSC_VER
+#include <direct.h>
+
+#define mkdir(dir, mode) _mkdir(dir)
+#endif
+
+namespace OptCuts
+{
+
+    const int channel_initial = 0;
+    const int channel_result = 1;
+    const int channel_findExtrema = 2;
+
+    const double convTol_upperBound = 1.0e-3;
+
+    const char checkpointMagic[4] = {'O', 'C', 'C', 'K'};
+    const int checkpointVersion = 1;
+
+    // the data read by TriMesh::saveAsMesh() with F0 and by saveAsBinaryMesh(), for saving on the output thread
+    static std::shared_ptr<const TriMesh> snapshotForOutput(const TriMesh& mesh)
+    {
+        std::shared_ptr<TriMesh> snapshot = std::make_shared<TriMesh>();
+        snapshot->V_rest = mesh.V_rest;
+        snapshot->V = mesh.V;
+        snapshot->F = mesh.F;
+        snapshot->cohE = mesh.cohE;
+        return snapshot;
+    }
+
+    static int computeOptPicked(const std::vector<std::pair<double, double>>& energyChanges0,
+                                const std::vector<std::pair<double, double>>& energyChanges1, double lambda)
+    {
+        assert(!energyChanges0.empty());
+        assert(!energyChanges1.empty());
+        assert((lambda >= 0.0) && (lambda <= 1.0));
+
+        double minEChange0 = __DBL_MAX__;
+        for (int ecI = 0; ecI < energyChanges0.size(); ecI++)
+        {
+            if ((energyChanges0[ecI].first == __DBL_MAX__) || (energyChanges0[ecI].second == __DBL_MAX__))
+            {
+                continue;
+            }
+            double EwChange = energyChanges0[ecI].first * (1.0 - lambda) + energyChanges0[ecI].second * lambda;
+            if (EwChange < minEChange0)
+            {
+                minEChange0 = EwChange;
+            }
+        }
+
+        double minEChange1 = __DBL_MAX__;
+        for (int ecI = 0; ecI < energyChanges1.size(); ecI++)
+        {
+            if ((energyChanges1[ecI].first == __DBL_MAX__) || (energyChanges1[ecI].second == __DBL_MAX__))
+            {
+                continue;
+            }
+            double EwChange = energyChanges1[ecI].first * (1.0 - lambda) + energyChanges1[ecI].second * lambda;
+            if (EwChange < minEChange1)
+            {
+                minEChange1 = EwChange;
+            }
+        }
+
+        assert((minEChange0 != __DBL_MAX__) || (minEChange1 != __DBL_MAX__));
+        return (minEChange0 > minEChange1);
+    }
+
+    static int computeBestCand(const std::vector<std::pair<double, double>>& energyChanges, double lambda, double& bestEChange)
+    {
+        assert((lambda >= 0.0) && (lambda <= 1.0));
+
+        bestEChange = __DBL_MAX__;
+        int id_minEChange = -1;
+        for (int ecI = 0; ecI < energyChanges.size(); ecI++)
+        {
+            if ((energyChanges[ecI].first == __DBL_MAX__) || (energyChanges[ecI].second == __DBL_MAX__))
+            {
+                continue;
+            }
+            double EwChange = energyChanges[ecI].first * (1.0 - lambda) + energyChanges[ecI].second * lambda;
+            if (EwChange < bestEChange)
+            {
+                bestEChange = EwChange;
+                id_minEChange = ecI;
+            }
+        }
+
+        return id_minEChange;
+    }
+
+    static bool checkCand(const std::vector<std::pair<double, double>>& energyChanges)
+    {
+        for (const auto& candI : energyChanges)
+        {
+            if ((candI.first < 0.0) || (candI.second < 0.0))
+            {
+                return true;
+            }
+        }
+
+        double minEChange = __DBL_MAX__;
+        for (const auto& candI : energyChanges)
+        {
+            if (candI.first < minEChange)
+            {
+                minEChange = candI.first;
+            }
+            if (candI.second < minEChange)
+            {
+                minEChange = candI.second;
+            }
+        }
+
+        // candidates|候选
+        // std::cout << "candidates not valid, minEChange: " << minEChange << std::endl;
+        return false;
+    }
+
+    Session::Session(void)
+        : stopRequested(false)
+    {
+        vertAmt_input = 0;
+        optimizer = NULL;
+
+        bijectiveParam = true;
+        rand1PInitCut = false;
+        lambda_init = 0.999;
+
+        iterNum = 0;
+        converged = 0;
+        fracThres = 0.0;
+        topoLineSearch = true;
+        outerLoopFinished = false;
+        upperBound = 4.1;
+
+        opType_queried = -1;
+        reQuery = false;
+
+        saveResultMeshes = true;
+        profiling = false;
+
+        secPast = 0.0;
+        time(&lastStart_world);
+        firstFeasibleS_reached = firstFeasible_reached = false;
+
+        iterNum_bestFeasible = -1;
+        E_se_bestFeasible = __DBL_MAX__;
+        lastStationaryIterNum = 0;
+
+        checkpointInterval = 300.0;
+        time(&lastCheckpointTime);
+
+        timeBudget = 0.0;
+        maxIterNum = 0;
+        time(&startTime);
+    }
+
+    Session::~Session(void) { releaseResources(); }
+
+    void Session::releaseResources(void)
+    {
+        if (profiling)
+        {
+            // run() did not reach saveResults()
+            profiler.release();
+            profiling = false;
+        }
+        outputQueue.stop();
+        reportCheckpointError();
+        context.logFile.close();
+        context.metricsSink.close();
+
+        for (auto& eI : energyTerms)
+        {
+            if (eI) delete eI;
+        }
+
+        energyTerms.clear();
+
+        if (optimizer) delete optimizer;
+        optimizer = NULL;
+        if (!triSoup.empty() && triSoup[0]) delete triSoup[0];
+        triSoup.clear();
+    }
+
+    // distortion energy and seam length of the current result
+    void Session::computeResultQuality(double& distortion, double& seamLen) const
+    {
+        if (energyParams[0] == 1.0)
+        {
+            // pure distortion minimization mode for models with initial cuts also reflected on the surface as boundary edges...
+            triSoup[channel_result]->computeBoundaryLen(seamLen);
+            seamLen /= 2.0;
+        }
+        else
+        {
+            triSoup[channel_result]->computeSeamSparsity(seamLen, !context.fractureMode);
+        }
+        energyTerms[0]->computeEnergyVal(*triSoup[channel_result], distortion);
+    }
+
+    void Session::saveInfoForPresent(const std::string fileName)
+    {
+        std::ofstream file;
+        file.open(context.outputFolderPath + fileName);
+        assert(file.is_open());
+
+        file << vertAmt_input << " " << triSoup[channel_initial]->F.rows() << std::endl;
+
+        file << iterNum << " " << optimizer->getTopoIter() << " 0 0 " << lambda_init << " " << 1.0 - energyParams[0] << std::endl;
+
+        Timer& timer = context.timer;
+        Timer& timer_step = context.timer_step;
+        file << "0.0 0.0 " << timer.timing_total() << " " << secPast << " topo" << timer.timing(0) << " desc" << timer.timing(1) << " scaf"
+             << timer.timing(2) << " enUp" << timer.timing(3) << " mtrComp" << timer_step.timing(0) << " mtrAssem" << timer_step.timing(1) << " symFac"
+             << timer_step.timing(2) << " numFac" << timer_step.timing(3) << " backSolve" << timer_step.timing(4) << " lineSearch" << timer_step.timing(5)
+             << " bSplit" << timer_step.timing(6) << " iSplit" << timer_step.timing(7) << " cMerge" << timer_step.timing(8)
+             << " lsTrials" << optimizer->getAvgLineSearchTrialAmt();
+        int energyValHit, gradientHit, seamSparsityHit;
+        optimizer->getEvalCacheHits(energyValHit, gradientHit, seamSparsityHit);
+        file << " EHit" << energyValHit << " gHit" << gradientHit << " EseHit" << seamSparsityHit << std::endl;
+
+        double distortion, seamLen;
+        computeResultQuality(distortion, seamLen);
+        file << distortion << " " << seamLen / triSoup[channel_result]->virtualRadius << std::endl;
+
+        triSoup[channel_result]->outputStandardStretch(file);
+
+        file << "initialSeams " << triSoup[channel_result]->initSeams.rows() << std::endl;
+        file << triSoup[channel_result]->initSeams << std::endl;
+
+        file.close();
+    }
+
+    void Session::proceedOptimization(int proceedNum)
+    {
+        for (int proceedI = 0; (proceedI < proceedNum) && (!converged); proceedI++)
+        {
+            // 迭代
+            std::cout << "-- it " << iterNum << " : ";
+            // 优化求解|收敛
+            converged = optimizer->solve(1);
+            iterNum = optimizer->getIterNum();
+        }
+    }
+
+    double Session::updateLambda(double measure_bound, double kappa, double kappa2) const
+    {
+        const double lambda_SD = std::max(0.0, kappa * (measure_bound - (upperBound - convTol_upperBound / 2.0)) +
+                                                   kappa2 * energyParams[0] / (1.0 - energyParams[0]));
+        return lambda_SD / (1.0 + lambda_SD);
+    }
+
+    // structured record of a dual update or of how the homotopy ended
+    void Session::writeDualMetrics(const char* event, double lambda_prev, double E_SD, double E_se, double measure_bound)
+    {
+        if (!context.metricsSink.isOpen())
+        {
+            return;
+        }
+        MetricsRecord record("dual");
+        record.add("event", event).add("iter", iterNum).add("topoIter", optimizer->getTopoIter());
+        record.add("lambda_prev", lambda_prev).add("lambda", 1.0 - energyParams[0]);
+        record.add("E_SD", E_SD).add("E_se", E_se).add("measure", measure_bound).add("upperBound", upperBound);
+        record.add("opQueried", opType_queried);
+        context.metricsSink.emit(record);
+    }
+
+    bool Session::updateLambda_stationaryV(bool cancelMomentum, bool checkConvergence)
+    {
+        Eigen::MatrixXd edgeLengths;
+        igl::edge_lengths(triSoup[channel_result]->V_rest, triSoup[channel_result]->F, edgeLengths);
+        const double eps_E_se = 1.0e-3 * edgeLengths.minCoeff() / triSoup[channel_result]->virtualRadius;
+
+        // measurement and energy value computation
+        const double E_SD = optimizer->getLastEnergyVal(true) / energyParams[0];
+        double E_se;
+        triSoup[channel_result]->computeSeamSparsity(E_se);
+        E_se /= triSoup[channel_result]->virtualRadius;
+        double stretch_l2, stretch_inf, stretch_shear, compress_inf;
+        triSoup[channel_result]->computeStandardStretch(stretch_l2, stretch_inf, stretch_shear, compress_inf);
+        double measure_bound = E_SD;
+        const double lambda_prev = 1.0 - energyParams[0];
+        const double eps_lambda = std::min(1.0e-3, std::abs(updateLambda(measure_bound) - energyParams[0]));
+
+        // TODO?: stop when first violates bounds from feasible, don't go to best feasible. check after each merge whether distortion is violated
+        //  oscillation detection
+        if (iterNum != lastStationaryIterNum)
+        {
+            // not a roll back config
+            const double lambda = 1.0 - energyParams[0];
+            bool oscillate = false;
+            const auto low = configs_stationaryV.lower_bound(E_se);
+            if (low == configs_stationaryV.end())
+            {
+                // all less than E_se
+                if (!configs_stationaryV.empty())
+                {
+                    // use largest element
+                    if (std::abs(configs_stationaryV.rbegin()->first - E_se) < eps_E_se)
+                    {
+                        for (const auto& lambdaI : configs_stationaryV.rbegin()->second)
+                        {
+                            if ((std::abs(lambdaI.first - lambda) < eps_lambda) && (std::abs(lambdaI.second - E_SD) < eps_E_se))
+                            {
+                                oscillate = true;
+                                context.logFile << configs_stationaryV.rbegin()->first << ", " << lambdaI.second << "\n";
+                                context.logFile << E_se << ", " << lambda << ", " << E_SD << "\n";
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            else if (low == configs_stationaryV.begin())
+            {
+                // all not less than E_se
+                if (std::abs(low->first - E_se) < eps_E_se)
+                {
+                    for (const auto& lambdaI : low->second)
+                    {
+                        if ((std::abs(lambdaI.first - lambda) < eps_lambda) && (std::abs(lambdaI.second - E_SD) < eps_E_se))
+                        {
+                            oscillate = true;
+                            context.logFile << low->first << ", " << lambdaI.first << ", " << lambdaI.second << "\n";
+                            context.logFile << E_se << ", " << lambda << ", " << E_SD << "\n";
+                            break;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                const auto prev = std::prev(low);
+                if (std::abs(low->first - E_se) < eps_E_se)
+                {
+                    for (const auto& lambdaI : low->second)
+                    {
+                        if ((std::abs(lambdaI.first - lambda) < eps_lambda) && (std::abs(lambdaI.second - E_SD) < eps_E_se))
+                        {
+                            oscillate = true;
+                            context.logFile << low->first << ", " << lambdaI.first << ", " << lambdaI.second << "\n";
+                            context.logFile << E_se << ", " << lambda << ", " << E_SD << "\n";
+                            break;
+                        }
+                    }
+                }
+                if ((!oscillate) && (std::abs(prev->first - E_se) < eps_E_se))
+                {
+                    for (const auto& lambdaI : prev->second)
+                    {
+                        if ((std::abs(lambdaI.first - lambda) < eps_lambda) && (std::abs(lambdaI.second - E_SD) < eps_E_se))
+                        {
+                            oscillate = true;
+                            context.logFile << prev->first << ", " << lambdaI.first << ", " << lambdaI.second << "\n";
+                            context.logFile << E_se << ", " << lambda << ", " << E_SD << "\n";
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // record best feasible UV map
+            if ((measure_bound <= upperBound) && (E_se < E_se_bestFeasible))
+            {
+                iterNum_bestFeasible = iterNum;
+                triSoup_bestFeasible = *triSoup[channel_result];
+                E_se_bestFeasible = E_se;
+            }
+
+            if (oscillate && (iterNum_bestFeasible >= 0))
+            {
+                // arrive at the best feasible config again
+                context.logFile << "oscillation detected at measure = " << measure_bound << ", b = " << upperBound << "lambda = " << energyParams[0]
+                                << "\n";
+                context.logFile << lastStationaryIterNum << ", " << iterNum << "\n";
+                if (iterNum_bestFeasible != iterNum)
+                {
+                    optimizer->setConfig(triSoup_bestFeasible, iterNum, optimizer->getTopoIter());
+                    context.logFile << "rolled back to best feasible in iter " << iterNum_bestFeasible << "\n";
+                }
+                writeDualMetrics("oscillation", lambda_prev, E_SD, E_se, measure_bound);
+                return false;
+            }
+            else
+            {
+                configs_stationaryV[E_se].emplace_back(std::pair<double, double>(lambda, E_SD));
+            }
+        }
+        lastStationaryIterNum = iterNum;
+
+        // convergence check
+        if (checkConvergence)
+        {
+            if (measure_bound <= upperBound)
+            {
+                // save info at first feasible stationaryVT for comparison
+                if (!firstFeasibleS_reached)
+                {
+                    //                logFile << "saving firstFeasibleS...\n";
+                    //                triSoup[channel_result]->saveAsMesh(outputFolderPath + "firstFeasibleS_mesh.obj", F);
+                    secPast += difftime(time(NULL), lastStart_world);
+                    time(&lastStart_world);
+                    firstFeasibleS_reached = true;
+                    //                logFile << "firstFeasibleS saved\n";
+                }
+
+                if (measure_bound >= upperBound - convTol_upperBound)
+                {
+                    context.logFile << "all converged at measure = " << measure_bound << ", b = " << upperBound << " lambda = " << energyParams[0]
+                                    << "\n";
+                    if (iterNum_bestFeasible != iterNum)
+                    {
+                        assert(iterNum_bestFeasible >= 0);
+                        optimizer->setConfig(triSoup_bestFeasible, iterNum, optimizer->getTopoIter());
+                        context.logFile << "rolled back to best feasible in iter " << iterNum_bestFeasible << "\n";
+                    }
+                    writeDualMetrics("converged", lambda_prev, E_SD, E_se, measure_bound);
+                    return false;
+                }
+            }
+        }
+
+        // lambda update (dual update)
+        energyParams[0] = updateLambda(measure_bound);
+        // TODO: needs to be careful on lambda update space
+
+        // critical lambda scheme
+        if (checkConvergence)
+        {
+            // update lambda until feasible update on T might be triggered
+            if (measure_bound > upperBound)
+            {
+                // need to cut further, increase energyParams[0]
+                context.logFile << "curUpdated = " << energyParams[0] << ", increase\n";
+
+                if ((!context.energyChanges_merge.empty()) &&
+                    (computeOptPicked(context.energyChanges_bSplit, context.energyChanges_merge, 1.0 - energyParams[0]) == 1))
+                {
+                    // still picking merge
+                    do
+                    {
+                        energyParams[0] = updateLambda(measure_bound);
+                    } while ((computeOptPicked(context.energyChanges_bSplit, context.energyChanges_merge, 1.0 - energyParams[0]) == 1));
+
+                    context.logFile << "iterativelyUpdated = " << energyParams[0] << ", increase for switch\n";
+                }
+
+                if ((!checkCand(context.energyChanges_iSplit)) && (!checkCand(context.energyChanges_bSplit)))
+                {
+                    // if filtering too strong
+                    reQuery = true;
+                    context.logFile << "enlarge filtering!\n";
+                }
+                else
+                {
+                    double eDec_b, eDec_i;
+                    assert(!(context.energyChanges_bSplit.empty() && context.energyChanges_iSplit.empty()));
+                    int id_pickingBSplit = computeBestCand(context.energyChanges_bSplit, 1.0 - energyParams[0], eDec_b);
+                    int id_pickingISplit = computeBestCand(context.energyChanges_iSplit, 1.0 - energyParams[0], eDec_i);
+                    while ((eDec_b > 0.0) && (eDec_i > 0.0))
+                    {
+                        energyParams[0] = updateLambda(measure_bound);
+                        id_pickingBSplit = computeBestCand(context.energyChanges_bSplit, 1.0 - energyParams[0], eDec_b);
+                        id_pickingISplit = computeBestCand(context.energyChanges_iSplit, 1.0 - energyParams[0], eDec_i);
+                    }
+                    if (eDec_b <= 0.0)
+                    {
+                        opType_queried = 0;
+                        path_queried = context.paths_bSplit[id_pickingBSplit];
+                        newVertPos_queried = context.newVertPoses_bSplit[id_pickingBSplit];
+                    }
+                    else
+                    {
+                        opType_queried = 1;
+                        path_queried = context.paths_iSplit[id_pickingISplit];
+                        newVertPos_queried = context.newVertPoses_iSplit[id_pickingISplit];
+                    }
+
+                    context.logFile << "iterativelyUpdated = " << energyParams[0] << ", increased, current eDec = " << eDec_b << ", " << eDec_i
+                            << "; id: " << id_pickingBSplit << ", " << id_pickingISplit << std::endl;
+                }
+            }
+            else
+            {
+                bool noOp = true;
+                for (const auto ecI : context.energyChanges_merge)
+                {
+                    if (ecI.first != __DBL_MAX__)
+                    {
+                        noOp = false;
+                        break;
+                    }
+                }
+                if (noOp)
+                {
+                    context.logFile << "No merge operation available, end process!\n";
+                    energyParams[0] = 1.0 - eps_lambda;
+                    optimizer->updateEnergyData(true, false, false);
+                    if (iterNum_bestFeasible != iterNum)
+                    {
+                        optimizer->setConfig(triSoup_bestFeasible, iterNum, optimizer->getTopoIter());
+                    }
+                    writeDualMetrics("noMerge", lambda_prev, E_SD, E_se, measure_bound);
+                    return false;
+                }
+
+                context.logFile << "curUpdated = " << energyParams[0] << ", decrease\n";
+
+                //!!! also account for iSplit for this switch?
+                if (computeOptPicked(context.energyChanges_bSplit, context.energyChanges_merge, 1.0 - energyParams[0]) == 0)
+                {
+                    // still picking split
+                    do
+                    {
+                        energyParams[0] = updateLambda(measure_bound);
+                    } while (computeOptPicked(context.energyChanges_bSplit, context.energyChanges_merge, 1.0 - energyParams[0]) == 0);
+
+                    context.logFile << "iterativelyUpdated = " << energyParams[0] << ", decrease for switch\n";
+                }
+
+                double eDec_m;
+                assert(!context.energyChanges_merge.empty());
+                int id_pickingMerge = computeBestCand(context.energyChanges_merge, 1.0 - energyParams[0], eDec_m);
+                while (eDec_m > 0.0)
+                {
+                    energyParams[0] = updateLambda(measure_bound);
+                    id_pickingMerge = computeBestCand(context.energyChanges_merge, 1.0 - energyParams[0], eDec_m);
+                }
+                opType_queried = 2;
+                path_queried = context.paths_merge[id_pickingMerge];
+                newVertPos_queried = context.newVertPoses_merge[id_pickingMerge];
+
+                context.logFile << "iterativelyUpdated = " << energyParams[0] << ", decreased, current eDec = " << eDec_m << "\n";
+            }
+        }
+
+        // lambda value sanity check
+        if (energyParams[0] > 1.0 - eps_lambda)
+        {
+            energyParams[0] = 1.0 - eps_lambda;
+        }
+        if (energyParams[0] < eps_lambda)
+        {
+            energyParams[0] = eps_lambda;
+        }
+
+        optimizer->updateEnergyData(true, false, false);
+
+        context.logFile << "measure = " << measure_bound << ", b = " << upperBound << ", updated lambda = " << energyParams[0] << "\n";
+        writeDualMetrics("update", lambda_prev, E_SD, E_se, measure_bound);
+        return true;
+    }
+
+    // serialize the state at the end of an inner loop and write it in the background,
+    // Optimizer::setConfig() restores the optimizer from it
+    void Session::saveCheckpoint(void)
+    {
+        if ((checkpointInterval <= 0.0) || (difftime(time(NULL), lastCheckpointTime) < checkpointInterval))
+        {
+            return;
+        }
+        time(&lastCheckpointTime);
+
+        std::ostringstream out(std::ios::out | std::ios::binary);
+        out.write(checkpointMagic, 4);
+        BinaryIO::write(out, checkpointVersion);
+
+        BinaryIO::write(out, iterNum);
+        BinaryIO::write(out, optimizer->getTopoIter());
+        BinaryIO::write(out, optimizer->getPropagateFracture());
+        BinaryIO::write<char>(out, optimizer->isScaffolding());
+        BinaryIO::write(out, energyParams[0]);
+        BinaryIO::write(out, context.filterExp_in);
+        triSoup[channel_result]->saveState(out);
+
+        BinaryIO::write(out, iterNum_bestFeasible);
+        BinaryIO::write(out, E_se_bestFeasible);
+        BinaryIO::write(out, lastStationaryIterNum);
+        if (iterNum_bestFeasible >= 0)
+        {
+            triSoup_bestFeasible.saveState(out);
+        }
+        BinaryIO::write<int64_t>(out, configs_stationaryV.size());
+        for (const auto& configI : configs_stationaryV)
+        {
+            BinaryIO::write(out, configI.first);
+            BinaryIO::write<int64_t>(out, configI.second.size());
+            for (const auto& lambdaI : configI.second)
+            {
+                BinaryIO::write(out, lambdaI.first);
+                BinaryIO::write(out, lambdaI.second);
+            }
+        }
+
+        reportCheckpointError();
+        checkpointSaver.save(context.outputFolderPath + "checkpoint.bin", out.str());
+        context.logFile << "checkpoint at iter " << iterNum << "\n";
+        context.logFile.flush();  // the log is on disk up to the state a resumed run continues from
+    }
+
+    // of the last checkpoint, which is saved in the background
+    void Session::reportCheckpointError(void)
+    {
+        std::string error;
+        if (checkpointSaver.takeError(error))
+        {
+            std::cerr << "failed to save checkpoint: " << error << std::endl;
+            context.logFile << "failed to save checkpoint: " << error << "\n";
+        }
+    }
+
+    // restore the state written by saveCheckpoint(), leaves everything untouched on failure
+    bool Session::loadCheckpoint(const std::string& filePath)
+    {
+        std::ifstream in(filePath, std::ios::in | std::ios::binary);
+        char magic[4];
+        int version;
+        if (!in.is_open() || !in.read(magic, 4) || !std::equal(magic, magic + 4, checkpointMagic) || !BinaryIO::read(in, version) ||
+            (version != checkpointVersion))
+        {
+            return false;
+        }
+
+        int p_iterNum, p_topoIter, p_propagateFracture;
+        char p_scaffolding;
+        double p_lambda_SD, p_filterExp_in;
+        TriMesh config;
+        if (!(BinaryIO::read(in, p_iterNum) && BinaryIO::read(in, p_topoIter) && BinaryIO::read(in, p_propagateFracture) &&
+              BinaryIO::read(in, p_scaffolding) && BinaryIO::read(in, p_lambda_SD) && BinaryIO::read(in, p_filterExp_in) &&
+              config.loadState(in)))
+        {
+            return false;
+        }
+
+        int p_iterNum_bestFeasible, p_lastStationaryIterNum;
+        double p_E_se_bestFeasible;
+        TriMesh p_triSoup_bestFeasible;
+        int64_t configAmt;
+        if (!(BinaryIO::read(in, p_iterNum_bestFeasible) && BinaryIO::read(in, p_E_se_bestFeasible) &&
+              BinaryIO::read(in, p_lastStationaryIterNum) && ((p_iterNum_bestFeasible < 0) || p_triSoup_bestFeasible.loadState(in)) &&
+              BinaryIO::read(in, configAmt)))
+        {
+            return false;
+        }
+        std::map<double, std::vector<std::pair<double, double>>> p_configs_stationaryV;
+        for (int64_t configI = 0; configI < configAmt; configI++)
+        {
+            double E_se;
+            int64_t lambdaAmt;
+            if (!(BinaryIO::read(in, E_se) && BinaryIO::read(in, lambdaAmt)))
+            {
+                return false;
+            }
+            auto& lambdas = p_configs_stationaryV[E_se];
+            lambdas.resize(std::max<int64_t>(0, lambdaAmt));
+            for (auto& lambdaI : lambdas)
+            {
+                if (!(BinaryIO::read(in, lambdaI.first) && BinaryIO::read(in, lambdaI.second)))
+                {
+                    return false;
+                }
+            }
+        }
+        if (config.F.rows() != triSoup[channel_result]->F.rows())
+        {
+            // topology operations keep the triangles, this is from another input
+            return false;
+        }
+
+        iterNum = p_iterNum;
+        energyParams[0] = p_lambda_SD;
+        context.filterExp_in = p_filterExp_in;
+        iterNum_bestFeasible = p_iterNum_bestFeasible;
+        E_se_bestFeasible = p_E_se_bestFeasible;
+        lastStationaryIterNum = p_lastStationaryIterNum;
+        triSoup_bestFeasible = p_triSoup_bestFeasible;
+        configs_stationaryV.swap(p_configs_stationaryV);
+
+        if (p_scaffolding && !optimizer->isScaffolding())
+        {
+            optimizer->setScaffolding(true);
+        }
+        optimizer->setConfig(config, iterNum, p_topoIter);
+        optimizer->setPropagateFracture(p_propagateFracture);
+        return true;
+    }
+
+    // the progress callback may request to stop
+    void Session::reportProgress(void)
+    {
+        if (!callbacks.progress)
+        {
+            return;
+        }
+        Progress progress;
+        progress.iterNum = iterNum;
+        progress.topoIter = optimizer->getTopoIter();
+        progress.lambda = 1.0 - energyParams[0];
+        progress.distortion = optimizer->getLastEnergyVal(true) / energyParams[0];
+        triSoup[channel_result]->computeSeamSparsity(progress.seamLen);
+        progress.seamLen /= triSoup[channel_result]->virtualRadius;
+        progress.uvVertAmt = static_cast<int>(triSoup[channel_result]->V.rows());
+        if (!callbacks.progress(progress))
+        {
+            stopRequested = true;
+        }
+    }
+
+    // at least one inner iteration is performed
+    bool Session::budgetExceeded(void) const
+    {
+        return (iterNum > 0) && (stopRequested || ((timeBudget > 0.0) && (difftime(time(NULL), startTime) >= timeBudget)) ||
+                                 ((maxIterNum > 0) && (iterNum >= maxIterNum)));
+    }
+
+    // end the homotopy early with the best feasible configuration seen so far,
+    // or the current one if it is better or nothing feasible was reached
+    void Session::finishWithinBudget(void)
+    {
+        const double lambda_SD = 1.0 - energyParams[0];
+        const double E_SD = optimizer->getLastEnergyVal(true) / energyParams[0];
+        double E_se;
+        triSoup[channel_result]->computeSeamSparsity(E_se);
+        E_se /= triSoup[channel_result]->virtualRadius;
+
+        context.logFile << (stopRequested ? "stop requested" : "budget reached") << " at iter " << iterNum << ", measure = " << E_SD << ", b = " << upperBound << "\n";
+        if ((E_SD <= upperBound) && (E_se <= E_se_bestFeasible))
+        {
+            context.logFile << "output current feasible config\n";
+        }
+        else if (iterNum_bestFeasible >= 0)
+        {
+            optimizer->setConfig(triSoup_bestFeasible, iterNum, optimizer->getTopoIter());
+            context.logFile << "rolled back to best feasible in iter " << iterNum_bestFeasible << "\n";
+        }
+        else
+        {
+            context.logFile << "no feasible config within the budget, output current config\n";
+        }
+        writeDualMetrics("budget", lambda_SD, E_SD, E_se, E_SD);
+
+        infoName = "finalResult";
+        secPast += difftime(time(NULL), lastStart_world);
+        optimizer->flushEnergyFileOutput();
+        optimizer->flushGradFileOutput();
+        std::cout << "optimization stopped " << (stopRequested ? "on request" : "by budget") << ", with " << secPast << "s." << std::endl;
+        outerLoopFinished = true;
+    }
+
+    void Session::finishConverged(void)
+    {
+        infoName = "finalResult";
+
+        bool stopped = false;
+        if (!bijectiveParam)
+        {
+            // perform exact solve
+            optimizer->setAllowEDecRelTol(false);
+            converged = false;
+            optimizer->setPropagateFracture(false);
+
+            while (!converged)
+            {
+                if (budgetExceeded())
+                {
+                    // the topology is final, so the current configuration is kept as it is
+                    stopped = true;
+                    context.logFile << (stopRequested ? "stop requested" : "budget reached") << " at iter " << iterNum
+                                    << " during exact solve, output current config\n";
+                    break;
+                }
+                proceedOptimization();
+            }
+        }
+
+        secPast += difftime(time(NULL), lastStart_world);
+
+        optimizer->flushEnergyFileOutput();
+        optimizer->flushGradFileOutput();
+
+        if (stopped)
+        {
+            std::cout << "optimization stopped " << (stopRequested ? "on request" : "by budget") << ", with " << secPast << "s." << std::endl;
+        }
+        else
+        {
+            std::cout << "optimization converged, with " << secPast << "s." << std::endl;
+            context.logFile << "optimization converged, with " << secPast << "s.\n";
+        }
+        outerLoopFinished = true;  // 预告结束
+    }
+
+    void Session::stepOuterLoop(void)
+    {
+        // 收敛|converged
+        while (!converged)
+        {
+            if (budgetExceeded())
+            {
+                finishWithinBudget();
+                return;
+            }
+            proceedOptimization();
+        }
+
+        if (!converged) return;
+
+        double stretch_l2, stretch_inf, stretch_shear, compress_inf;
+        triSoup[channel_result]->computeStandardStretch(stretch_l2, stretch_inf, stretch_shear, compress_inf);
+        double measure_bound = optimizer->getLastEnergyVal(true) / energyParams[0];
+
+        // case MT_OPTCUTS:
+        infoName = std::to_string(iterNum);
+        if (converged == 2)
+        {
+            converged = 0;
+            return;
+        }
+
+        // a consistent point to resume from, the decisions below only depend on the saved state
+        saveCheckpoint();
+
+        reportProgress();
+        if (budgetExceeded())
+        {
+            finishWithinBudget();
+            return;
+        }
+
+        if (measure_bound <= upperBound)
+        {
+            // save info once bound is reached for comparison
+            if (!firstFeasible_reached)
+            {
+                //                            triSoup[channel_result]->save(outputFolderPath + infoName + "_triSoup.obj");
+                //                            triSoup[channel_result]->saveAsMesh(outputFolderPath + "firstFeasible_mesh.obj", F);
+                secPast += difftime(time(NULL), lastStart_world);
+                time(&lastStart_world);
+                firstFeasible_reached = true;
+            }
+        }
+
+        // if necessary, turn on scaffolding for random one point initial cut
+        if (!optimizer->isScaffolding() && bijectiveParam && rand1PInitCut)
+        {
+            optimizer->setScaffolding(true);
+        }
+
+        double E_se;
+        triSoup[channel_result]->computeSeamSparsity(E_se);
+        E_se /= triSoup[channel_result]->virtualRadius;
+        const double E_SD = optimizer->getLastEnergyVal(true) / energyParams[0];
+
+        // 迭代|重新计算??
+        std::cout << "-- it " << iterNum << " : " << E_SD << " " << E_se << " " << triSoup[channel_result]->V_rest.rows() << std::endl;
+        context.logFile << iterNum << ": " << E_SD << " " << E_se << " " << triSoup[channel_result]->V_rest.rows() << "\n";
+        optimizer->flushEnergyFileOutput();
+        optimizer->flushGradFileOutput();
+
+        // continue to split boundary
+        if (!updateLambda_stationaryV())
+        {
+            // oscillation detected
+            finishConverged();
+            return;
+        }
+
+        context.logFile << "boundary op V " << triSoup[channel_result]->V_rest.rows() << "\n";
+        if (optimizer->createFracture(fracThres, false, topoLineSearch))
+        {
+            converged = false;
+            return;
+        }
+
+        // if no boundary op, try interior split if split is the current best boundary op
+        if ((measure_bound > upperBound) && optimizer->createFracture(fracThres, false, topoLineSearch, true))
+        {
+            context.logFile << "interior split " << triSoup[channel_result]->V_rest.rows() << "\n";
+            converged = false;
+            return;
+        }
+
+        if (!updateLambda_stationaryV(false, true))
+        {
+            // all converged
+            finishConverged();
+            return;
+        }
+
+        // split or merge after lambda update
+        if (reQuery)
+        {
+            context.filterExp_in += std::log(2.0) / std::log(context.inSplitTotalAmt);
+            context.filterExp_in = std::min(1.0, context.filterExp_in);
+            while (!optimizer->createFracture(fracThres, false, topoLineSearch, true))
+            {
+                context.filterExp_in += std::log(2.0) / std::log(context.inSplitTotalAmt);
+                context.filterExp_in = std::min(1.0, context.filterExp_in);
+            }
+            reQuery = false;
+            // TODO: set filtering param back?
+        }
+        else
+        {
+            optimizer->createFracture(opType_queried, path_queried, newVertPos_queried, topoLineSearch);
+        }
+
+        opType_queried = -1;
+        converged = false;
+    }
+
+    void Session::saveResults(void)
+    {
+        double distortion, seamLen;
+        computeResultQuality(distortion, seamLen);
+        std::map<std::string, double> meta;
+        meta["lambda"] = 1.0 - energyParams[0];
+        meta["lambda_init"] = lambda_init;
+        meta["upperBound"] = upperBound;
+        meta["distortion"] = distortion;
+        meta["seamLen"] = seamLen;
+        meta["virtualRadius"] = triSoup[channel_result]->virtualRadius;
+        meta["iterNum"] = iterNum;
+        meta["topoIter"] = optimizer->getTopoIter();
+
+        // 保存模型
+        if (saveResultMeshes)
+        {
+            const std::shared_ptr<const TriMesh> result = snapshotForOutput(*triSoup[channel_result]);
+            const std::string filePath = context.outputFolderPath + infoName + "_mesh";
+            outputQueue.post([this, result, filePath]() { result->saveAsMesh(filePath + ".obj", F); });
+            outputQueue.post([this, result, filePath]() { result->saveAsMesh(filePath + "_normalizedUV.obj", F, true); });
+            outputQueue.post([this, result, filePath, meta]() { result->saveAsBinaryMesh(filePath + ".ocmesh", F, meta, true); });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            triSoup[channel_result]->getBinaryMesh(F, meta, resultMesh);
+        }
+
+        // saveInfoForPresent();  // info.txt
+
+        if (profiling)
+        {
+            // zone timings, percentiles per Newton iteration and topology step, and a Chrome trace
+            profiler.writeSummary(context.outputFolderPath + "profile.txt");
+            profiler.writeChromeTrace(context.outputFolderPath + "profile_trace.json");
+            profiler.release();
+            profiling = false;
+        }
+    }
+
+    bool Session::checkInput(void)
+    {
+        vertAmt_input = V.rows();
+        if (F.rows() == 0)
+        {
+            std::cout << "input mesh has no triangles!" << std::endl;
+            return false;
+        }
+
+        Eigen::VectorXi B;
+        bool isManifold = igl::is_vertex_manifold(F, B) && igl::is_edge_manifold(F);
+        if (!isManifold)
+        {
+            std::cout << "input mesh contains non-manifold edges or vertices" << std::endl;
+            std::cout << "please cleanup the mesh and retry" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool Session::load(const std::string& meshFilePath)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (vertAmt_input > 0)
+        {
+            return false;
+        }
+
+        // Load mesh
+        const size_t suffixPos = meshFilePath.find_last_of('.');
+        const std::string suffix = ((suffixPos == std::string::npos) ? "" : meshFilePath.substr(suffixPos));
+        bool loadSucceed = false;
+        if (suffix == ".off")
+        {
+            loadSucceed = MeshIO::readOFF(meshFilePath, V, F);
+        }
+        else if (suffix == ".obj")
+        {
+            // 输入数据
+            loadSucceed = MeshIO::readOBJ(meshFilePath, V, UV, N, F, FUV, FN);
+        }
+        else
+        {
+            std::cout << "unkown mesh file format!" << std::endl;
+            return false;
+        }
+
+        if (!loadSucceed)
+        {
+            std::cout << "failed to load mesh!" << std::endl;
+            return false;
+        }
+        return checkInput();
+    }
+
+    bool Session::load(const Eigen::MatrixXd& p_V, const Eigen::MatrixXi& p_F, const Eigen::MatrixXd& p_UV, const Eigen::MatrixXi& p_FUV)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ((vertAmt_input > 0) || (p_V.cols() != 3) || (p_F.cols() != 3) || ((p_UV.rows() != 0) && (p_FUV.rows() != p_F.rows())))
+        {
+            return false;
+        }
+
+        V = p_V;
+        F = p_F;
+        UV = p_UV;
+        FUV = p_FUV;
+        return checkInput();
+    }
+
+    bool Session::hasInputUV(void) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (UV.rows() != 0);
+    }
+
+    bool Session::initUV(const Options& options)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return computeInitialUV(options);
+    }
+
+    bool Session::computeInitialUV(const Options& options)
+    {
+        if ((vertAmt_input == 0) || !triSoup.empty())
+        {
+            return false;
+        }
+        bijectiveParam = options.bijective;
+        const int initCutOption = options.initCutOption;
+        if ((initCutOption != 0) && (initCutOption != 1))
+        {
+            std::cout << "invalid initCutOption " << initCutOption << std::endl;
+            return false;
+        }
+
+        if (UV.rows() != 0)
+        {
+            // with input UV
+            // 构造输入 Mesh|自带UV
+            TriMesh* temp = new TriMesh(V, F, UV, FUV, false);
+
+            std::vector<std::vector<int>> bnd_all;
+            igl::boundary_loop(temp->F, bnd_all);
+
+            // TODO: check input UV genus (validity)
+            // right now OptCuts assumes input UV is a set of topological disks
+
+            bool recompute_UV_needed = !temp->checkInversion();
+            if ((!recompute_UV_needed) && bijectiveParam && (bnd_all.size() > 1))
+            {
+                // TODO: check overlaps and decide whether needs recompute UV
+                // needs to check even if bnd_all.size() == 1
+                // right now OptCuts take the input seams and recompute UV by default when bijective mapping is enabled
+                recompute_UV_needed = true;
+            }
+            if (recompute_UV_needed)
+            {
+                std::cout << "local injectivity violated in given input UV map, "
+                          << "or multi-chart bijective UV map needs to be ensured, "
+                          << "obtaining new initial UV map by applying Tutte's embedding..." << std::endl;
+
+                // harmonic map with uniform weights per chart, using a grid layout for multiple charts
+                Eigen::VectorXi C;
+                igl::facet_components(temp->F, C);
+                std::vector<Eigen::MatrixXi> F_chart(C.maxCoeff() + 1);
+                IglUtils::splitFaceComponents(temp->F, C, F_chart);
+                IglUtils::harmonicParam_multiComp(temp->V_rest, F_chart, temp->V);
+
+                if (!temp->checkInversion())
+                {
+                    std::cout << "local injectivity still violated in the computed initial UV map, "
+                              << "please carefully check UV topology for e.g. non-manifold vertices. "
+                              << "Exit program..." << std::endl;
+                    delete temp;
+                    return false;
+                }
+            }
+
+            // 输入
+            triSoup.emplace_back(temp);
+        }
+        else
+        {
+            // no UV provided, compute initial UV
+
+            Eigen::VectorXi C;
+            igl::facet_components(F, C);
+            int n_components = C.maxCoeff() + 1;
+            std::cout << n_components << " disconnected components in total" << std::endl;
+
+            // 构造输入 Mesh|没有UV
+            // in each pass, compute the cuts of all components in parallel and make them in one batch,
+            // until all becoming disk-topology
+            TriMesh temp(V, F, Eigen::MatrixXd(), Eigen::MatrixXi(), false);
+            std::vector<Eigen::MatrixXi> F_component(n_components);
+            IglUtils::splitFaceComponents(temp.F, C, F_component);
+            while (true)
+            {
+                std::vector<int> EC(n_components);
+                std::vector<std::vector<std::vector<int>>> cuts_component(n_components);
+                tbb::parallel_for(0, n_components, 1, [&](int componentI) {
+                    EC[componentI] = IglUtils::eulerCharacteristic(F_component[componentI]);
+                    if (EC[componentI] < 1)
+                    {
+                        igl::cut_to_disk(F_component[componentI], cuts_component[componentI]);  // Meshes with boundary are supported; boundary edges will be included as cuts.
+                    }
+                });
+
+                std::vector<int> components_to_cut;
+                std::vector<std::vector<int>> cuts;
+                for (int componentI = 0; componentI < n_components; ++componentI)
+                {
+                    // std::cout << ">>> component " << componentI << std::endl;
+
+                    std::cout << "euler_characteristic " << EC[componentI] << std::endl;
+                    if (EC[componentI] < 1)
+                    {
+                        // treat as higher-genus surfaces using cut_to_disk()
+                        components_to_cut.emplace_back(-componentI - 1);
+                        std::cout << cuts_component[componentI].size() << " seams to cut component " << componentI << std::endl;
+                        cuts.insert(cuts.end(), cuts_component[componentI].begin(), cuts_component[componentI].end());
+                    }
+                    else if (EC[componentI] == 2)
+                    {
+                        // closed genus-0 surface
+                        components_to_cut.emplace_back(componentI);
+                    }
+                    else if (EC[componentI] != 1)
+                    {
+                        std::cout << "unsupported single-connected component!" << std::endl;
+                        return false;
+                    }
+                }
+                std::cout << components_to_cut.size() << " components to cut to disk" << std::endl;
+
+                if (components_to_cut.empty())
+                {
+                    break;
+                }
+
+                if (!cuts.empty())
+                {
+                    // cut high genus, all seams at once so that their vertex ids stay consistent
+                    if (!temp.cutPaths(cuts, true))
+                    {
+                        std::cout << "FATAL ERROR: no cuts made when cutting input geometry to disk-topology!" << std::endl;
+                        return false;
+                    }
+                    temp.initSeams = temp.cohE;
+                }
+
+                std::vector<int> farthestPointCutSeeds;  // cut together to share the graph and run the queries in parallel
+                for (auto componentI : components_to_cut)
+                {
+                    if (componentI < 0)
+                    {
+                        continue;
+                    }
+
+                    // cut the topological sphere into a topological disk
+                    switch (initCutOption)
+                    {
+                        case 0:
+                            temp.onePointCut(F_component[componentI](0, 0));
+                            rand1PInitCut = (n_components == 1);
+                            break;
+
+                        case 1:
+                            farthestPointCutSeeds.emplace_back(F_component[componentI](0, 0));
+                            break;
+
+                        default:
+                            std::cout << "invalid initCutOption " << initCutOption << std::endl;
+                            assert(0);
+                            break;
+                    }
+                }
+                if (!farthestPointCutSeeds.empty())
+                {
+                    temp.farthestPointCut(farthestPointCutSeeds);
+                }
+
+                // data update on each component for identifying a new cut
+                IglUtils::splitFaceComponents(temp.F, C, F_component);
+            }
+
+            // harmonic map with uniform weights per component, using a grid layout for multiComp
+            Eigen::MatrixXd UV_Tutte;
+            IglUtils::harmonicParam_multiComp(temp.V_rest, F_component, UV_Tutte);
+
+            // 输入
+            triSoup.emplace_back(new TriMesh(V, F, UV_Tutte, temp.F, false));
+        }
+
+        return true;
+    }
+
+    bool Session::run(const Options& options, const Callbacks& p_callbacks)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (optimizer || outerLoopFinished || (triSoup.empty() && !computeInitialUV(options)))
+        {
+            // not loaded, or already run
+            return false;
+        }
+
+        if ((options.lambda_init != options.lambda_init) || (options.lambda_init < 0.0) || (options.lambda_init >= 1.0))
+        {
+            std::cout << "invalid lambda " << options.lambda_init << std::endl;
+            return false;
+        }
+        if (!(options.upperBound > 4.0))
+        {
+            std::cout << "invalid b_d " << options.upperBound << ", needs to be > 4.0" << std::endl;
+            return false;
+        }
+        if (options.outputFolderPath.empty())
+        {
+            std::cout << "no output folder" << std::endl;
+            return false;
+        }
+
+        time(&startTime);
+        time(&lastStart_world);
+
+        lambda_init = options.lambda_init;
+        upperBound = options.upperBound;
+        bijectiveParam = options.bijective;
+        context.methodType = MT_OPTCUTS;
+        context.bSplitCandBudget.timeBudget = std::max(0.0, options.candidateTimeBudget);
+        context.bSplitCandBudget.adaptive = options.adaptiveCandidateBudget;
+        checkpointInterval = options.checkpointInterval;
+        timeBudget = options.timeBudget;
+        maxIterNum = options.maxIterNum;
+        saveResultMeshes = options.saveResultMeshes;
+        callbacks = p_callbacks;
+
+        context.outputFolderPath = options.outputFolderPath;
+        if (context.outputFolderPath.back() == '/')
+        {
+            context.outputFolderPath.pop_back();
+        }
+        mkdir(context.outputFolderPath.c_str(), 0777);
+        context.outputFolderPath += '/';
+
+        // 保存输入初始状态
+        if (saveResultMeshes)
+        {
+            const std::shared_ptr<const TriMesh> initial = snapshotForOutput(*triSoup.back());
+            const std::string filePath = context.outputFolderPath + "initial_cuts";
+            std::map<std::string, double> meta;
+            meta["lambda_init"] = lambda_init;
+            meta["upperBound"] = upperBound;
+            outputQueue.post([this, initial, filePath, meta]() {
+                igl::writeOBJ(filePath + ".obj", initial->V_rest, initial->F);
+                initial->saveAsBinaryMesh(filePath + ".ocmesh", F, meta, true);
+            });
+        }
+        context.logFile.open(context.outputFolderPath + "log.txt", options.resume ? std::ios::app : std::ios::out);
+        if (!context.logFile.is_open())
+        {
+            std::cout << "failed to create log file, please ensure output directory is created successfully!" << std::endl;
+            return false;
+        }
+        context.metricsSink.open(context.outputFolderPath + "metrics.jsonl", options.resume);
+
+        // setup timer
+        context.timer.new_activity("topology");
+        context.timer.new_activity("descent");
+        context.timer.new_activity("scaffolding");
+        context.timer.new_activity("energyUpdate");
+
+        context.timer_step.new_activity("matrixComputation");
+        context.timer_step.new_activity("matrixAssembly");
+        context.timer_step.new_activity("symbolicFactorization");
+        context.timer_step.new_activity("numericalFactorization");
+        context.timer_step.new_activity("backSolve");
+        context.timer_step.new_activity("lineSearch");
+        context.timer_step.new_activity("boundarySplit");
+        context.timer_step.new_activity("interiorSplit");
+        context.timer_step.new_activity("cornerMerge");
+
+        // the flat totals above are kept for info.txt, the profiler adds the
+        // per-thread hierarchy and distributions, it is process-wide
+        // and so owned by one session at a time
+        profiling = (options.profiling && profiler.claim());
+        if (options.profiling && !profiling)
+        {
+            std::cout << "profiler is in use by another session, not profiling" << std::endl;
+            context.logFile << "profiler is in use by another session, not profiling\n";
+        }
+
+        // * Our approach
+        energyParams.emplace_back(1.0 - lambda_init);
+        energyTerms.emplace_back(new SymDirichletEnergy());
+
+        if (!triSoup[0]->checkInversion())
+        {
+            // the optimizer would terminate the process
+            std::cout << "element inversion in the initial UV map!" << std::endl;
+            return false;
+        }
+
+        // 优化器
+        optimizer = new Optimizer(context, *triSoup[0], energyTerms, energyParams, 0, false,
+                                  bijectiveParam && !rand1PInitCut);  // for random one point initial cut, don't need air meshes in the beginning
+                                                                      // since it's impossible for a quad to intersect itself
+        // the snapshot before each topology step is only for visualization
+        optimizer->setSnapshotFindExtrema(false);
+        optimizer->setIncrementalScaffold(options.incrementalScaffold, options.scaffoldQualityThres);
+        optimizer->precompute();
+
+        triSoup.emplace_back(&optimizer->getResult());
+        triSoup.emplace_back(&optimizer->getData_findExtrema());  // for visualizing UV map for finding extrema
+
+        if (lambda_init > 0.0)
+        {
+            // fracture mode
+            context.fractureMode = true;
+        }
+
+        /////////////////////////////////////////////////////////////////////////////
+        // regional seam placement
+        if (!options.selectionFilePath.empty())
+        {
+            const std::string& filePath = options.selectionFilePath;
+            const bool binary = ((filePath.size() >= 7) && (filePath.compare(filePath.size() - 7, 7, ".ocmesh") == 0));
+            Eigen::VectorXd& vertWeight = optimizer->getResult().vertWeight;
+            std::vector<char> selected;
+            if (!(binary ? BinaryMesh::readSelection(filePath, static_cast<int>(vertWeight.size()), selected)
+                         : MeshIO::readSelection(filePath, static_cast<int>(vertWeight.size()), selected)))
+            {
+                std::cout << "failed to read the vertex selection " << filePath << std::endl;
+                return false;
+            }
+            for (int vI = 0; vI < vertWeight.size(); vI++)
+            {
+                if (selected[vI])
+                {
+                    vertWeight[vI] = 100.0;
+                }
+            }
+
+            IglUtils::smoothVertField(optimizer->getResult(), vertWeight, options.selectionSmoothingIterAmt);
+
+            std::cout << "OptCuts with regional seam placement" << std::endl;
+        }
+        //////////////////////////////////////////////////////////////////////////////
+
+        if (options.resume)
+        {
+            if (loadCheckpoint(context.outputFolderPath + "checkpoint.bin"))
+            {
+                // continue with the decisions after the inner loop that was checkpointed
+                converged = 1;
+                std::cout << "resumed from checkpoint at iter " << iterNum << std::endl;
+                context.logFile << "resumed from checkpoint at iter " << iterNum << "\n";
+            }
+            else
+            {
+                std::cout << "no valid checkpoint in " << context.outputFolderPath << ", start from the beginning" << std::endl;
+            }
+        }
+        time(&lastCheckpointTime);
+
+        // 正式求解计算
+        while (!outerLoopFinished)
+        {
+            stepOuterLoop();
+        }
+        saveResults();
+
+        // 释放资源
+        releaseResources();
+
+        return true;
+    }
+
+    void Session::requestStop(void) { stopRequested = true; }
+
+    BinaryMesh::Result Session::result(void) const
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        return resultMesh;
+    }
+
+    int Session::runCommandLine(int argc, char* argv[], bool allowProfiling)
+    {
+        // headless mode
+        std::cout << "Headless mode" << std::endl;
+
+        Options options;
+
+        // options, taken out before the positional arguments are parsed
+        std::vector<char*> args;
+        for (int argI = 0; argI < argc; argI++)
+        {
+            const std::string arg(argv[argI]);
+            if (arg == "--resume")
+            {
+                // continue from checkpoint.bin in the output folder of the same arguments
+                options.resume = true;
+            }
+            else if ((arg == "--checkpoint-interval") && (argI + 1 < argc))
+            {
+                options.checkpointInterval = std::stod(argv[++argI]);
+            }
+            else if ((arg == "--time-budget") && (argI + 1 < argc))
+            {
+                options.timeBudget = std::stod(argv[++argI]);
+            }
+            else if ((arg == "--candidate-time-budget") && (argI + 1 < argc))
+            {
+                // seconds per topology step for evaluating boundary split candidates, 0 for unlimited
+                options.candidateTimeBudget = std::stod(argv[++argI]);
+                if ((options.candidateTimeBudget != options.candidateTimeBudget) || (options.candidateTimeBudget < 0.0))
+                {
+                    std::cout << "Overwrite invalid candidate time budget " << options.candidateTimeBudget << " to 0 (unlimited)" << std::endl;
+                    options.candidateTimeBudget = 0.0;
+                }
+            }
+            else if (arg == "--adaptive-candidates")
+            {
+                options.adaptiveCandidateBudget = true;
+            }
+            else if (arg == "--incremental-scaffold")
+            {
+                options.incrementalScaffold = true;
+            }
+            else if ((arg == "--scaffold-quality") && (argI + 1 < argc))
+            {
+                options.scaffoldQualityThres = std::stod(argv[++argI]);
+            }
+            else if (arg == "--profile")
+            {
+                options.profiling = allowProfiling;
+            }
+            else if ((arg == "--max-iters") && (argI + 1 < argc))
+            {
+                options.maxIterNum = std::stoi(argv[++argI]);
+            }
+            else if ((arg == "--selection-smoothing") && (argI + 1 < argc))
+            {
+                options.selectionSmoothingIterAmt = std::max(0, std::stoi(argv[++argI]));
+            }
+            else
+            {
+                args.emplace_back(argv[argI]);
+            }
+        }
+        argc = static_cast<int>(args.size());
+        argv = args.data();
+
+        // Optimization mode
+        const std::string outputRootPath = "output/";
+        mkdir(outputRootPath.c_str(), 0777);
+
+        std::string meshFileName("cone2.0.obj");
+        if (argc > 2)
+        {
+            meshFileName = std::string(argv[2]);
+        }
+        std::string meshFilePath = meshFileName;
+        meshFileName = meshFileName.substr(meshFileName.find_last_of('/') + 1);
+
+        std::string meshFolderPath = meshFilePath.substr(0, meshFilePath.find_last_of('/'));
+        std::string meshName = meshFileName.substr(0, meshFileName.find_last_of('.'));
+
+        if (!load(meshFilePath))
+        {
+            return -1;
+        }
+
+        // Set lambda
+        if (argc > 3)
+        {
+            options.lambda_init = std::stod(argv[3]);
+            if ((options.lambda_init != options.lambda_init) || (options.lambda_init < 0.0) || (options.lambda_init >= 1.0))
+            {
+                std::cout << "Overwrite invalid lambda " << options.lambda_init << " to 0.999" << std::endl;
+                options.lambda_init = 0.999;
+            }
+        }
+        else
+        {
+            std::cout << "Use default lambda = " << options.lambda_init << std::endl;
+        }
+
+        // Set testID
+        double testID = 1.0;  // test id for naming result folder
+        if (argc > 4)
+        {
+            testID = std::stod(argv[4]);
+            if ((testID != testID) || (testID < 0.0))
+            {
+                std::cout << "Overwrite invalid testID " << testID << " to 1" << std::endl;
+                testID = 1.0;
+            }
+        }
+        else
+        {
+            std::cout << "Use default testID = " << testID << std::endl;
+        }
+
+        std::string startDS;
+
+        // extern 访问|argv[5]
+        // switch (methodType)
+        // case MT_OPTCUTS:
+        {
+            startDS = "OptCuts";
+            std::cout << ">>> method: OptCuts." << std::endl;
+        }
+
+        if (argc > 6)
+        {
+            options.upperBound = std::stod(argv[6]);
+            if (options.upperBound == 0.0)
+            {
+                // read in b_d for comparing to other methods
+                bool useScriptedBound = false;
+                std::ifstream distFile(outputRootPath + "distortion.txt");
+                assert(distFile.is_open());
+
+                std::string resultName;
+                double resultDistortion;
+                while (!distFile.eof())
+                {
+                    distFile >> resultName >> resultDistortion;
+                    if ((resultName.find(meshName + "_Tutte_") != std::string::npos) || (resultName.find(meshName + "_input_") != std::string::npos) ||
+                        (resultName.find(meshName + "_HighGenus_") != std::string::npos) ||
+                        (resultName.find(meshName + "_rigid_") != std::string::npos) || (resultName.find(meshName + "_zbrush_") != std::string::npos) ||
+                        (resultName.find(meshName + "_unwrella_") != std::string::npos))
+                    {
+                        useScriptedBound = true;
+                        options.upperBound = resultDistortion;
+                        assert(options.upperBound > 4.0);
+                        break;
+                    }
+                }
+                distFile.close();
+
+                assert(useScriptedBound);
+                std::cout << "Use scripted b_d = " << options.upperBound << std::endl;
+            }
+            else
+            {
+                if (options.upperBound <= 4.0)
+                {
+                    std::cout << "input b_d <= 4.0! use 4.1 instead." << std::endl;
+                    options.upperBound = 4.1;
+                }
+                else
+                {
+                    std::cout << "use b_d = " << options.upperBound << std::endl;
+                }
+            }
+        }
+
+        if (argc > 7)
+        {
+            options.bijective = std::stoi(argv[7]);
+            std::cout << "bijectivity " << (options.bijective ? "ON" : "OFF") << std::endl;
+        }
+
+        if (argc > 8)
+        {
+            options.initCutOption = std::stoi(argv[8]);
+        }
+        switch (options.initCutOption)
+        {
+            case 0:
+                std::cout << "random 2-edge initial cut for genus-0 closed surface" << std::endl;
+                break;
+
+            case 1:
+                std::cout << "farthest 2-point initial cut for genus-0 closed surface" << std::endl;
+                break;
+
+            default:
+                std::cout << "input initial cut option invalid, use default" << std::endl;
+                std::cout << "random 2-edge initial cut for genus-0 closed surface" << std::endl;
+                options.initCutOption = 0;
+                break;
+        }
+
+        std::string folderTail = "";
+        if (argc > 9)
+        {
+            if (argv[9][0] != '_')
+            {
+                folderTail += '_';
+            }
+            folderTail += argv[9];
+        }
+
+        options.outputFolderPath = outputRootPath + meshName + (hasInputUV() ? "_input_" : "_Tutte_") + IglUtils::rtos(options.lambda_init) + "_" +
+                                   IglUtils::rtos(testID) + "_" + startDS + folderTail;
+        // the binary selection takes precedence
+        for (const char* suffix : {"_selected.ocmesh", "_selected.txt"})
+        {
+            const std::string selectionFilePath = meshFolderPath + "/" + meshName + suffix;
+            if (std::ifstream(selectionFilePath).is_open())
+            {
+                options.selectionFilePath = selectionFilePath;
+                break;
+            }
+        }
+
+        return (run(options) ? 0 : -1);
+    }
+
+}  // namespace OptCuts
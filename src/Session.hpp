@@ -0,0 +1,214 @@
+//
+//  Session.hpp
+//  OptCuts
+//
+
+#ifndef Session_hpp
+#define Session_hpp
+
+#include "AsyncFileWriter.hpp"
+#include "BinaryMesh.hpp"
+#include "Optimizer.hpp"
+#include "RunContext.hpp"
+#include "TriMesh.hpp"
+
+#include <Eigen/Eigen>
+
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OptCuts {
+
+    // one OptCuts run on one mesh with its own optimizer, log and output folder:
+    //
+    //     Session session;
+    //     session.load("bunny.obj");        // or load(V, F, UV, FUV)
+    //     session.initUV(options);          // optional, run() does it if necessary
+    //     session.run(options, callbacks);  // alternates the inner solve, topology operations
+    //                                       // and dual updates until converged or stopped
+    //     BinaryMesh::Result uvMap = session.result();
+    //
+    // several sessions can run concurrently in one process, their parallel loops use the
+    // TBB arena of the calling thread, the calls of one session are serialized and
+    // result() and requestStop() can be called from any thread while run() is in progress
+    class Session {
+    public:
+        struct Options {
+            // created if missing (not its parent), receives log.txt, metrics.jsonl,
+            // energyValPerIter.txt, gradientPerIter.txt, checkpoint.bin and the result meshes
+            std::string outputFolderPath;
+            double lambda_init = 0.999; // initial weight of the seam term, in [0, 1)
+            double upperBound = 4.1; // distortion bound on the symmetric Dirichlet energy, > 4
+            bool bijective = true; // whether to keep the UV map free of overlaps with air meshes
+            // initUV(): cut of closed genus-0 components, 0: random one-point cut, 1: farthest two-point cut
+            int initCutOption = 0;
+            double candidateTimeBudget = 0.0; // seconds per topology step for boundary split candidates, 0: unlimited
+            // let the amount of boundary split candidates follow the ranks of recent winners
+            // instead of the fixed pow(n, 0.8), changes the result
+            bool adaptiveCandidateBudget = false;
+            // keep the air mesh between topology changes and only retriangulate around air triangles
+            // of a quality below scaffoldQualityThres, instead of reconstructing it after every iteration
+            bool incrementalScaffold = false;
+            double scaffoldQualityThres = 0.2;
+            double checkpointInterval = 300.0; // seconds between checkpoints, 0: no checkpoints
+            bool resume = false; // continue from checkpoint.bin in the output folder if it is valid
+            double timeBudget = 0.0; // seconds of wall-clock time, 0: unlimited
+            int maxIterNum = 0; // inner iterations, 0: unlimited
+            // regional seam placement: whitespace-separated indices of the selected vertices, or a
+            // binary selection (.ocmesh, see BinaryMesh::writeSelection()), empty for none
+            std::string selectionFilePath;
+            int selectionSmoothingIterAmt = 1; // smoothing steps of the seam weights around the selection
+            // initial_cuts.obj/.ocmesh and finalResult_mesh.obj/_normalizedUV.obj/.ocmesh
+            bool saveResultMeshes = true;
+            // enable the process-wide profiler and write profile.txt and profile_trace.json,
+            // ignored while another session profiles, zones of sessions running at the
+            // same time are included
+            bool profiling = false;
+        };
+
+        // the state after an inner loop converged
+        struct Progress {
+            int iterNum, topoIter;
+            double lambda; // current weight of the seam term
+            double distortion; // symmetric Dirichlet energy
+            double seamLen; // normalized by the radius of a sphere with the same surface area
+            int uvVertAmt;
+        };
+
+        struct Callbacks {
+            // called on the thread of run() before each topology step,
+            // returning false stops like a budget does
+            std::function<bool(const Progress&)> progress;
+        };
+
+    protected:
+        RunContext context;
+        mutable std::mutex mutex; // serializes the API calls
+        mutable std::mutex resultMutex;
+        std::atomic<bool> stopRequested;
+        BinaryMesh::Result resultMesh;
+        Callbacks callbacks;
+
+        Eigen::MatrixXd V, UV, N;
+        Eigen::MatrixXi F, FUV, FN;
+
+        // optimization
+        std::vector<const TriMesh*> triSoup; // initial (owned), result, findExtrema
+        int vertAmt_input;
+        Optimizer* optimizer;
+        std::vector<Energy*> energyTerms;
+        std::vector<double> energyParams;
+
+        bool bijectiveParam;
+        bool rand1PInitCut;
+        double lambda_init;
+
+        int iterNum;
+        int converged;
+        double fracThres;
+        bool topoLineSearch;
+        bool outerLoopFinished;
+        double upperBound;
+
+        int opType_queried;
+        std::vector<int> path_queried;
+        Eigen::MatrixXd newVertPos_queried;
+        bool reQuery;
+
+        std::string infoName;
+        bool saveResultMeshes;
+        bool profiling;
+
+        double secPast;
+        time_t lastStart_world;
+        bool firstFeasibleS_reached, firstFeasible_reached;
+
+        // oscillation detection and best feasible record of the dual updates
+        int iterNum_bestFeasible;
+        TriMesh triSoup_bestFeasible;
+        double E_se_bestFeasible;
+        int lastStationaryIterNum; // still necessary because boundary and interior query are with same iterNum
+        std::map<double, std::vector<std::pair<double, double>>> configs_stationaryV;
+
+        // checkpoints are written after the inner loop converged if checkpointInterval seconds passed
+        double checkpointInterval; // 0: no checkpoints
+        time_t lastCheckpointTime;
+        AsyncFileSaver checkpointSaver;
+
+        // mesh saves run on this thread from copies of the data they write
+        AsyncOutputQueue outputQueue;
+
+        // budgeted mode: stop at a deadline or iteration cap and output the best feasible configuration
+        double timeBudget; // seconds of wall-clock time, 0: unlimited
+        int maxIterNum; // inner iterations, 0: unlimited
+        time_t startTime;
+
+    public: // constructor and destructor
+        Session(void);
+        ~Session(void);
+
+    public: // API
+        // .obj (with its texture coordinates as the initial UV map if there are any) or .off,
+        // false if the file cannot be read or the mesh is not manifold, a session takes one mesh
+        bool load(const std::string& meshFilePath);
+        bool load(const Eigen::MatrixXd& p_V, const Eigen::MatrixXi& p_F,
+                  const Eigen::MatrixXd& p_UV = Eigen::MatrixXd(), const Eigen::MatrixXi& p_FUV = Eigen::MatrixXi());
+        bool hasInputUV(void) const;
+
+        // cut the input to disks and compute a harmonic map of each unless a valid UV map was loaded,
+        // uses options.bijective and options.initCutOption
+        bool initUV(const Options& options);
+
+        // run the optimization once to the end, false if the input or the options are invalid
+        bool run(const Options& options, const Callbacks& p_callbacks = Callbacks());
+        // stop at the next check between inner iterations with the best feasible result so far
+        void requestStop(void);
+
+        // the input mesh with the UV map, seams and chart ids of the final result and the metadata
+        // lambda, lambda_init, upperBound, distortion, seamLen, virtualRadius, iterNum and topoIter,
+        // empty before run() finished
+        BinaryMesh::Result result(void) const;
+
+        // the command line of OptCuts_bin, argv[0] is the program name,
+        // outputs go to a folder under output/ named after the arguments,
+        // --profile is ignored if allowProfiling is false,
+        // returns the exit code of the run
+        int runCommandLine(int argc, char* argv[], bool allowProfiling = true);
+
+    protected: // helper functions
+        bool checkInput(void);
+        bool computeInitialUV(const Options& options);
+        void releaseResources(void);
+
+        void computeResultQuality(double& distortion, double& seamLen) const;
+        void saveInfoForPresent(const std::string fileName = "info.txt");
+
+        void proceedOptimization(int proceedNum = 1);
+        double updateLambda(double measure_bound, double kappa = 1.0, double kappa2 = 1.0) const;
+        void writeDualMetrics(const char* event, double lambda_prev, double E_SD, double E_se, double measure_bound);
+        bool updateLambda_stationaryV(bool cancelMomentum = true, bool checkConvergence = false);
+
+        void saveCheckpoint(void);
+        void reportCheckpointError(void);
+        bool loadCheckpoint(const std::string& filePath);
+
+        void reportProgress(void);
+        bool budgetExceeded(void) const;
+        void finishWithinBudget(void);
+
+        void finishConverged(void);
+        // one inner loop to convergence followed by a dual update and a topology step
+        void stepOuterLoop(void);
+        void saveResults(void);
+    };
+
+}
+
+#endif /* Session_hpp */
@@ -10,6 +10,7 @@
 #include <igl/avg_edge_length.h>
 #include <igl/boundary_loop.h>
 #include <igl/cotmatrix.h>
+#include <igl/facet_components.h>
 #include <igl/harmonic.h>
 #include <igl/list_to_matrix.h>
 #include <igl/writeOBJ.h>
@@ -17,20 +18,16 @@
 
 #include <fstream>
 
+#include "BinaryIO.hpp"
+#include "BinaryMesh.hpp"
 #include "IglUtils.hpp"
+#include "MeshGraph.hpp"
 #include "Optimizer.hpp"
+#include "Profiler.hpp"
+#include "RunContext.hpp"
 #include "SymDirichletEnergy.hpp"
 #include "Timer.hpp"
 
-extern std::ofstream logFile;
-extern Timer timer_step;
-
-extern std::vector<std::pair<double, double>> energyChanges_bSplit, energyChanges_iSplit, energyChanges_merge;
-extern std::vector<std::vector<int>> paths_bSplit, paths_iSplit, paths_merge;
-extern std::vector<Eigen::MatrixXd> newVertPoses_bSplit, newVertPoses_iSplit, newVertPoses_merge;
-extern double filterExp_in;
-extern int inSplitTotalAmt;
-
 namespace OptCuts
 {
 
@@ -331,8 +328,7 @@ namespace OptCuts
         {
             for (Eigen::SparseMatrix<double>::InnerIterator it(L, k); it; ++it)
             {
-                if ((fixedVert.find(static_cast<int>(it.row())) == fixedVert.end()) &&
-                    (fixedVert.find(static_cast<int>(it.col())) == fixedVert.end()))
+                if ((!isFixedVert(it.row())) && (!isFixedVert(it.col())))
                 {
                     LaplacianMtr.insert(it.row(), it.col()) = -it.value();
                 }
@@ -343,6 +339,16 @@ namespace OptCuts
             LaplacianMtr.insert(fixedVI, fixedVI) = 1.0;
         }
         LaplacianMtr.makeCompressed();
+        LaplacianMtrOutdated = false;
+    }
+
+    const Eigen::SparseMatrix<double>& TriMesh::getLaplacianMtr(void)
+    {
+        if (LaplacianMtrOutdated)
+        {
+            computeLaplacianMtr();
+        }
+        return LaplacianMtr;
     }
 
     void TriMesh::computeFeatures(bool multiComp, bool resetFixedV)
@@ -352,22 +358,57 @@ namespace OptCuts
             fixedVert.clear();
             fixedVert.insert(0);
         }
+        updateFixedVertMask();
 
-        boundaryEdge.resize(cohE.rows());
-        edgeLen.resize(cohE.rows());
-        for (int cohI = 0; cohI < cohE.rows(); cohI++)
+        std::vector<Eigen::RowVector3d> vertNormals;
+        computeRestShapeFeatures(vertNormals);
+
+        computeLaplacianMtr();
+
+        bbox.block(0, 0, 1, 3) = V_rest.row(0);
+        bbox.block(1, 0, 1, 3) = V_rest.row(0);
+        for (int vI = 1; vI < V_rest.rows(); vI++)
         {
-            if (cohE.row(cohI).minCoeff() >= 0)
+            const Eigen::RowVector3d& v = V_rest.row(vI);
+            for (int dimI = 0; dimI < 3; dimI++)
             {
-                boundaryEdge[cohI] = 0;
+                if (v[dimI] < bbox(0, dimI))
+                {
+                    bbox(0, dimI) = v[dimI];
+                }
+                if (v[dimI] > bbox(1, dimI))
+                {
+                    bbox(1, dimI) = v[dimI];
+                }
             }
-            else
+        }
+
+        edge2Tri.clear();
+        vNeighbor.resize(0);
+        vNeighbor.resize(V_rest.rows());
+        for (int triI = 0; triI < F.rows(); triI++)
+        {
+            const Eigen::RowVector3i& triVInd = F.row(triI);
+            for (int vI = 0; vI < 3; vI++)
             {
-                boundaryEdge[cohI] = 1;
+                int vI_post = (vI + 1) % 3;
+                edge2Tri[std::pair<int, int>(triVInd[vI], triVInd[vI_post])] = triI;
+                vNeighbor[triVInd[vI]].insert(triVInd[vI_post]);
+                vNeighbor[triVInd[vI_post]].insert(triVInd[vI]);
             }
-            edgeLen[cohI] = (V_rest.row(cohE(cohI, 0)) - V_rest.row(cohE(cohI, 1))).norm();
         }
 
+        validSplit.resize(V_rest.rows());
+        for (int vI = 0; vI < V_rest.rows(); vI++)
+        {
+            computeValidSplit(vI, vertNormals[vI]);
+        }
+
+        computeSeamFeatures();
+    }
+
+    void TriMesh::computeRestShapeFeatures(std::vector<Eigen::RowVector3d>& vertNormals)
+    {
         triNormal.resize(F.rows(), 3);
         triArea.resize(F.rows());
         surfaceArea = 0.0;
@@ -378,7 +419,8 @@ namespace OptCuts
         e0SqLen_div_dbAreaSq.resize(F.rows());
         e1SqLen_div_dbAreaSq.resize(F.rows());
         e0dote1_div_dbAreaSq.resize(F.rows());
-        std::vector<Eigen::RowVector3d> vertNormals(V_rest.rows(), Eigen::Vector3d::Zero());
+        vertNormals.resize(0);
+        vertNormals.resize(V_rest.rows(), Eigen::Vector3d::Zero());
         bool isMeshInvalid = false;
         for (int triI = 0; triI < F.rows(); triI++)
         {
@@ -451,40 +493,26 @@ namespace OptCuts
         // std::cout << "avg e1SqLen_div_dbAreaSq =" << e1SqLen_div_dbAreaSq.sum() / e1SqLen_div_dbAreaSq.size() << std::endl;
         // std::cout << "avg e0dote1_div_dbAreaSq =" << e0dote1_div_dbAreaSq.sum() / e0dote1_div_dbAreaSq.size() << std::endl;
 
-        computeLaplacianMtr();
+        LaplacianMtrOutdated = true;
+    }
 
-        bbox.block(0, 0, 1, 3) = V_rest.row(0);
-        bbox.block(1, 0, 1, 3) = V_rest.row(0);
-        for (int vI = 1; vI < V_rest.rows(); vI++)
+    void TriMesh::computeSeamFeatures(void)
+    {
+        boundaryEdge.resize(cohE.rows());
+        edgeLen.resize(cohE.rows());
+        for (int cohI = 0; cohI < cohE.rows(); cohI++)
         {
-            const Eigen::RowVector3d& v = V_rest.row(vI);
-            for (int dimI = 0; dimI < 3; dimI++)
+            if (cohE.row(cohI).minCoeff() >= 0)
             {
-                if (v[dimI] < bbox(0, dimI))
-                {
-                    bbox(0, dimI) = v[dimI];
-                }
-                if (v[dimI] > bbox(1, dimI))
-                {
-                    bbox(1, dimI) = v[dimI];
-                }
+                boundaryEdge[cohI] = 0;
             }
-        }
-
-        edge2Tri.clear();
-        vNeighbor.resize(0);
-        vNeighbor.resize(V_rest.rows());
-        for (int triI = 0; triI < F.rows(); triI++)
-        {
-            const Eigen::RowVector3i& triVInd = F.row(triI);
-            for (int vI = 0; vI < 3; vI++)
+            else
             {
-                int vI_post = (vI + 1) % 3;
-                edge2Tri[std::pair<int, int>(triVInd[vI], triVInd[vI_post])] = triI;
-                vNeighbor[triVInd[vI]].insert(triVInd[vI_post]);
-                vNeighbor[triVInd[vI_post]].insert(triVInd[vI]);
+                boundaryEdge[cohI] = 1;
             }
+            edgeLen[cohI] = (V_rest.row(cohE(cohI, 0)) - V_rest.row(cohE(cohI, 1))).norm();
         }
+
         cohEIndex.clear();
         for (int cohI = 0; cohI < cohE.rows(); cohI++)
         {
@@ -496,35 +524,6 @@ namespace OptCuts
             }
         }
 
-        validSplit.resize(V_rest.rows());
-        for (int vI = 0; vI < V_rest.rows(); vI++)
-        {
-            validSplit[vI].clear();
-            if (isBoundaryVert(vI))
-            {
-                continue;
-            }
-
-            std::vector<int> nbVs(vNeighbor[vI].begin(), vNeighbor[vI].end());
-            std::vector<Eigen::RowVector3d> projectedEdge(nbVs.size());
-            for (int nbI = 0; nbI < nbVs.size(); nbI++)
-            {
-                const Eigen::RowVector3d edge = V_rest.row(nbVs[nbI]) - V_rest.row(vI);
-                projectedEdge[nbI] = (edge - edge.dot(vertNormals[vI]) * vertNormals[vI]).normalized();
-            }
-            for (int nbI = 0; nbI + 1 < nbVs.size(); nbI++)
-            {
-                for (int nbJ = nbI + 1; nbJ < nbVs.size(); nbJ++)
-                {
-                    if (projectedEdge[nbI].dot(projectedEdge[nbJ]) <= 0.0)
-                    {
-                        validSplit[vI].insert(std::pair<int, int>(nbVs[nbI], nbVs[nbJ]));
-                        validSplit[vI].insert(std::pair<int, int>(nbVs[nbJ], nbVs[nbI]));
-                    }
-                }
-            }
-        }
-
         // init fracture tail record
         fracTail.clear();
         for (int cohI = 0; cohI < cohE.rows(); cohI++)
@@ -552,6 +551,123 @@ namespace OptCuts
         }
     }
 
+    void TriMesh::computeVNeighbor(int vI, const std::set<int>& nbCandidates)
+    {
+        // candidates may be outdated, keep those still sharing an edge with vI
+        vNeighbor[vI].clear();
+        for (const auto& nbVI : nbCandidates)
+        {
+            if ((nbVI == vI) || (nbVI >= V_rest.rows()))
+            {
+                continue;
+            }
+            if ((edge2Tri.find(std::pair<int, int>(vI, nbVI)) != edge2Tri.end()) ||
+                (edge2Tri.find(std::pair<int, int>(nbVI, vI)) != edge2Tri.end()))
+            {
+                vNeighbor[vI].insert(nbVI);
+            }
+        }
+    }
+
+    void TriMesh::computeValidSplit(int vI, const Eigen::RowVector3d& vertNormal)
+    {
+        validSplit[vI].clear();
+        if (isBoundaryVert(vI))
+        {
+            return;
+        }
+
+        std::vector<int> nbVs(vNeighbor[vI].begin(), vNeighbor[vI].end());
+        std::vector<Eigen::RowVector3d> projectedEdge(nbVs.size());
+        for (int nbI = 0; nbI < nbVs.size(); nbI++)
+        {
+            const Eigen::RowVector3d edge = V_rest.row(nbVs[nbI]) - V_rest.row(vI);
+            projectedEdge[nbI] = (edge - edge.dot(vertNormal) * vertNormal).normalized();
+        }
+        for (int nbI = 0; nbI + 1 < nbVs.size(); nbI++)
+        {
+            for (int nbJ = nbI + 1; nbJ < nbVs.size(); nbJ++)
+            {
+                if (projectedEdge[nbI].dot(projectedEdge[nbJ]) <= 0.0)
+                {
+                    validSplit[vI].insert(std::pair<int, int>(nbVs[nbI], nbVs[nbJ]));
+                    validSplit[vI].insert(std::pair<int, int>(nbVs[nbJ], nbVs[nbI]));
+                }
+            }
+        }
+    }
+
+    void TriMesh::updateFeatures(const std::vector<int>& triangles, const std::vector<Eigen::RowVector3i>& triVInd_old)
+    {
+        // topology operations only relabel vertices of existing triangles with
+        // duplicated/merged vertices at the same rest position, so per-triangle
+        // features, avgEdgeLen, and bbox stay valid and only the indices
+        // around the given triangles need an update
+        assert(triangles.size() == triVInd_old.size());
+
+        // erase all old directed edges before inserting new ones,
+        // as an edge can move from one given triangle to another
+        std::set<int> vertsToUpdate;
+        for (const auto& triVInd : triVInd_old)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                edge2Tri.erase(std::pair<int, int>(triVInd[i], triVInd[(i + 1) % 3]));
+                if (triVInd[i] < V_rest.rows())
+                {
+                    vertsToUpdate.insert(triVInd[i]);
+                }
+            }
+        }
+        std::map<int, std::set<int>> nbCandidates;
+        for (const auto& triI : triangles)
+        {
+            const Eigen::RowVector3i& triVInd = F.row(triI);
+            for (int i = 0; i < 3; i++)
+            {
+                edge2Tri[std::pair<int, int>(triVInd[i], triVInd[(i + 1) % 3])] = triI;
+                vertsToUpdate.insert(triVInd[i]);
+                nbCandidates[triVInd[i]].insert(triVInd[(i + 1) % 3]);
+                nbCandidates[triVInd[i]].insert(triVInd[(i + 2) % 3]);
+            }
+        }
+
+        // neighbors through untouched triangles keep their indices,
+        // so they are covered by the previous vNeighbor of each vertex
+        vNeighbor.resize(V_rest.rows());
+        for (const auto& vI : vertsToUpdate)
+        {
+            std::set<int>& nbCandidatesI = nbCandidates[vI];
+            nbCandidatesI.insert(vNeighbor[vI].begin(), vNeighbor[vI].end());
+            computeVNeighbor(vI, nbCandidatesI);
+        }
+
+        validSplit.resize(V_rest.rows());
+        for (const auto& vI : vertsToUpdate)
+        {
+            Eigen::RowVector3d vertNormal = Eigen::RowVector3d::Zero();
+            for (const auto& nbVI : vNeighbor[vI])
+            {
+                // each incident triangle has exactly one directed edge starting from vI
+                auto finder = edge2Tri.find(std::pair<int, int>(vI, nbVI));
+                if (finder == edge2Tri.end())
+                {
+                    continue;
+                }
+                const Eigen::RowVector3i& triVInd = F.row(finder->second);
+                const Eigen::RowVector3d P2m1 = V_rest.row(triVInd[1]) - V_rest.row(triVInd[0]);
+                const Eigen::RowVector3d P3m1 = V_rest.row(triVInd[2]) - V_rest.row(triVInd[0]);
+                vertNormal += P2m1.cross(P3m1);
+            }
+            computeValidSplit(vI, vertNormal.normalized());
+        }
+
+        // seam records are proportional to the seam length, not the mesh size
+        computeSeamFeatures();
+
+        LaplacianMtrOutdated = true;
+    }
+
     void TriMesh::updateFeatures(void)
     {
         const int nCE = static_cast<int>(boundaryEdge.size());
@@ -570,7 +686,7 @@ namespace OptCuts
             edgeLen[cohI] = (V_rest.row(cohE(cohI, 0)) - V_rest.row(cohE(cohI, 1))).norm();
         }
 
-        computeLaplacianMtr();
+        LaplacianMtrOutdated = true;
     }
 
     void TriMesh::resetFixedVert(const std::set<int>& p_fixedVert)
@@ -581,7 +697,18 @@ namespace OptCuts
         }
 
         fixedVert = p_fixedVert;
-        computeLaplacianMtr();
+        updateFixedVertMask();
+        LaplacianMtrOutdated = true;
+    }
+
+    void TriMesh::updateFixedVertMask(void)
+    {
+        // assign() keeps the storage
+        fixedVertMask.assign(V_rest.rows(), false);
+        for (const auto& fixedVI : fixedVert)
+        {
+            fixedVertMask[fixedVI] = true;
+        }
     }
 
     void TriMesh::buildCohEfromRecord(const Eigen::MatrixXi& cohERecord)
@@ -606,11 +733,13 @@ namespace OptCuts
     void TriMesh::querySplit(double lambda_t, bool propagate, bool splitInterior, double& EwDec_max, std::vector<int>& path_max,
                              Eigen::MatrixXd& newVertPos_max, std::pair<double, double>& energyChanges_max) const
     {
-        timer_step.start(6 + splitInterior);
-
-        const double filterExp_b = 0.8, filterMult_b = 1.0;  // TODO: better use ratio
+        // NOTE: no timer_step here, this may run concurrently with queryMerge(),
+        // callers account for the time instead
+        OPTCUTS_PROFILE_ZONE("querySplit");
 
         std::vector<int> bestCandVerts;
+        int budgetAmt_b = 0;  // boundary candidates within the budget
+        bool sampleFull_b = false;  // evaluate all boundary candidates to measure regret
         if (!propagate)
         {
             SymDirichletEnergy SD;
@@ -646,7 +775,7 @@ namespace OptCuts
                         }
                     }
                 }
-                inSplitTotalAmt = sortedCandVerts_in.size();
+                context->inSplitTotalAmt = sortedCandVerts_in.size();
             }
             else
             {
@@ -672,11 +801,9 @@ namespace OptCuts
                     EwDec_max = 0.0;
                     return;
                 }
-                int bestCandAmt_b = static_cast<int>(std::pow(sortedCandVerts_b.size(), filterExp_b) * filterMult_b);
-                if (bestCandAmt_b < 2)
-                {
-                    bestCandAmt_b = 2;
-                }
+                budgetAmt_b = context->bSplitCandBudget.budget(static_cast<int>(sortedCandVerts_b.size()));
+                sampleFull_b = context->bSplitCandBudget.sampleFullEval();
+                const int bestCandAmt_b = (sampleFull_b ? static_cast<int>(sortedCandVerts_b.size()) : budgetAmt_b);
                 bestCandVerts.reserve(bestCandAmt_b);
                 for (const auto& candI : sortedCandVerts_b)
                 {
@@ -694,7 +821,7 @@ namespace OptCuts
                     EwDec_max = 0.0;
                     return;
                 }
-                int bestCandAmt_in = static_cast<int>(std::pow(sortedCandVerts_in.size(), filterExp_in));
+                int bestCandAmt_in = static_cast<int>(std::pow(sortedCandVerts_in.size(), context->filterExp_in));
                 if (bestCandAmt_in < 2)
                 {
                     bestCandAmt_in = 2;
@@ -726,7 +853,6 @@ namespace OptCuts
                     EwDec_max = -__DBL_MAX__;
                     path_max.resize(0);
                     newVertPos_max.resize(0, 2);
-                    timer_step.stop();
                     return;
                 }
                 else
@@ -753,11 +879,10 @@ namespace OptCuts
         // evaluate local energy decrease
         // std::cout << "evaluate vertex splits, " << bestCandVerts.size() << " candidate verts" << std::endl;
         // run in parallel:
-        static std::vector<double> EwDecs;
-        EwDecs.resize(bestCandVerts.size());
-        static std::vector<std::vector<int>> paths_p;
-        static std::vector<Eigen::MatrixXd> newVertPoses_p;
-        static std::vector<std::pair<double, double>> energyChanges_p;
+        std::vector<double> EwDecs(bestCandVerts.size());
+        std::vector<std::vector<int>> paths_p;
+        std::vector<Eigen::MatrixXd> newVertPoses_p;
+        std::vector<std::pair<double, double>> energyChanges_p;
         int operationType = -1;
         // query boundary splits
         if (!splitInterior)
@@ -777,15 +902,55 @@ namespace OptCuts
             else
             {
                 operationType = 0;
-                paths_bSplit.resize(0);
-                paths_bSplit.resize(bestCandVerts.size());
-                newVertPoses_bSplit.resize(bestCandVerts.size());
-                energyChanges_bSplit.resize(bestCandVerts.size());
+                context->paths_bSplit.resize(0);
+                context->paths_bSplit.resize(bestCandVerts.size());
+                context->newVertPoses_bSplit.resize(bestCandVerts.size());
+                context->energyChanges_bSplit.resize(bestCandVerts.size());
+                tbb::tick_count evalStart = tbb::tick_count::now();
                 tbb::parallel_for(0, (int)bestCandVerts.size(), 1,
                                   [&](int candI) {
-                                      EwDecs[candI] = computeLocalLDec(bestCandVerts[candI], lambda_t, paths_bSplit[candI],
-                                                                       newVertPoses_bSplit[candI], energyChanges_bSplit[candI]);
+                                      EwDecs[candI] = computeLocalLDec(bestCandVerts[candI], lambda_t, context->paths_bSplit[candI],
+                                                                       context->newVertPoses_bSplit[candI], context->energyChanges_bSplit[candI]);
                                   });
+                const double evalTime = (tbb::tick_count::now() - evalStart).seconds();
+
+                // candidates are sorted, so the index of the winner is its rank
+                int candI_winner = 0;
+                for (int candI = 1; candI < bestCandVerts.size(); candI++)
+                {
+                    if (EwDecs[candI] > EwDecs[candI_winner])
+                    {
+                        candI_winner = candI;
+                    }
+                }
+                context->bSplitCandBudget.record(static_cast<int>(bestCandVerts.size()),
+                                                 ((EwDecs[candI_winner] == -__DBL_MAX__) ? -1 : candI_winner), evalTime);
+                if (context->bSplitCandBudget.isLimited() || sampleFull_b)
+                {
+                    context->logFile << "boundary split candidates " << budgetAmt_b << "/" << bestCandVerts.size() << ", winner rank " << candI_winner
+                            << "\n";
+                }
+                if (sampleFull_b)
+                {
+                    // measure the regret of the budget, then proceed as if only the budgeted
+                    // candidates were evaluated so that sampling does not change the result
+                    int candI_budget = 0;
+                    for (int candI = 1; candI < budgetAmt_b; candI++)
+                    {
+                        if (EwDecs[candI] > EwDecs[candI_budget])
+                        {
+                            candI_budget = candI;
+                        }
+                    }
+                    context->logFile << "boundary split budget regret " << EwDecs[candI_winner] - EwDecs[candI_budget] << " (E_dec "
+                            << EwDecs[candI_winner] << " vs " << EwDecs[candI_budget] << ")\n";
+
+                    EwDecs.resize(budgetAmt_b);
+                    bestCandVerts.resize(budgetAmt_b);
+                    context->paths_bSplit.resize(budgetAmt_b);
+                    context->newVertPoses_bSplit.resize(budgetAmt_b);
+                    context->energyChanges_bSplit.resize(budgetAmt_b);
+                }
             }
         }
         else
@@ -793,15 +958,15 @@ namespace OptCuts
             assert(!propagate);
             operationType = 1;
             // query interior splits
-            paths_iSplit.resize(0);
-            paths_iSplit.resize(bestCandVerts.size());
-            newVertPoses_iSplit.resize(bestCandVerts.size());
-            energyChanges_iSplit.resize(bestCandVerts.size());
+            context->paths_iSplit.resize(0);
+            context->paths_iSplit.resize(bestCandVerts.size());
+            context->newVertPoses_iSplit.resize(bestCandVerts.size());
+            context->energyChanges_iSplit.resize(bestCandVerts.size());
             tbb::parallel_for(0, (int)bestCandVerts.size(), 1,
                               [&](int candI)
                               {
-                                  EwDecs[candI] = computeLocalLDec(bestCandVerts[candI], lambda_t, paths_iSplit[candI], newVertPoses_iSplit[candI],
-                                                                   energyChanges_iSplit[candI]);
+                                  EwDecs[candI] = computeLocalLDec(bestCandVerts[candI], lambda_t, context->paths_iSplit[candI],
+                                                                   context->newVertPoses_iSplit[candI], context->energyChanges_iSplit[candI]);
                                   if (EwDecs[candI] != -__DBL_MAX__)
                                   {
                                       EwDecs[candI] *= 0.5;
@@ -828,23 +993,21 @@ namespace OptCuts
                 break;
 
             case 0:
-                path_max = paths_bSplit[candI_max];
-                newVertPos_max = newVertPoses_bSplit[candI_max];
-                energyChanges_max = energyChanges_bSplit[candI_max];
+                path_max = context->paths_bSplit[candI_max];
+                newVertPos_max = context->newVertPoses_bSplit[candI_max];
+                energyChanges_max = context->energyChanges_bSplit[candI_max];
                 break;
 
             case 1:
-                path_max = paths_iSplit[candI_max];
-                newVertPos_max = newVertPoses_iSplit[candI_max];
-                energyChanges_max = energyChanges_iSplit[candI_max];
+                path_max = context->paths_iSplit[candI_max];
+                newVertPos_max = context->newVertPoses_iSplit[candI_max];
+                energyChanges_max = context->energyChanges_iSplit[candI_max];
                 break;
 
             default:
                 assert(0);
                 break;
         }
-
-        timer_step.stop();
     }
 
     bool TriMesh::splitEdge(double lambda_t, double thres, bool propagate, bool splitInterior)
@@ -853,11 +1016,17 @@ namespace OptCuts
         std::vector<int> path_max;
         Eigen::MatrixXd newVertPos_max;
         std::pair<double, double> energyChanges_max;
+        context->timer_step.start(6 + splitInterior);
         querySplit(lambda_t, propagate, splitInterior, EwDec_max, path_max, newVertPos_max, energyChanges_max);
+        context->timer_step.stop();
 
+        lastTopoOpType = -1;
         // std::cout << "E_dec threshold = " << thres << std::endl;
         if (EwDec_max > thres)
         {
+            lastTopoOpType = splitInterior;
+            lastTopoOpPath = path_max;
+            lastTopoOpEwDec = EwDec_max;
             if (!splitInterior)
             {
                 // boundary split
@@ -872,7 +1041,7 @@ namespace OptCuts
                 assert(!propagate);
                 // std::cout << "interior split E_dec = " << EwDec_max << std::endl;
                 cutPath(path_max, true, 1, newVertPos_max);
-                logFile << "interior edge splitted" << std::endl;
+                context->logFile << "interior edge splitted\n";
                 fracTail.insert(path_max[0]);
                 fracTail.insert(path_max[2]);
                 curInteriorFracTails.first = path_max[0];
@@ -889,20 +1058,15 @@ namespace OptCuts
     }
 
     void TriMesh::queryMerge(double lambda, bool propagate, double& localEwDec_max, std::vector<int>& path_max, Eigen::MatrixXd& newVertPos_max,
-                             std::pair<double, double>& energyChanges_max)
+                             std::pair<double, double>& energyChanges_max) const
     {
         // TODO: local index updates in mergeBoundaryEdge()
-        // TODO: parallelize the query
-        timer_step.start(8);
+        // NOTE: no timer_step here, this may run concurrently with querySplit(),
+        // callers account for the time instead
+        OPTCUTS_PROFILE_ZONE("queryMerge");
 
-        // std::cout << "evaluate edge merge, " << cohE.rows() << " cohesive edge pairs." << std::endl;
-        localEwDec_max = -__DBL_MAX__;
-        if (!propagate)
-        {
-            paths_merge.resize(0);
-            newVertPoses_merge.resize(0);
-            energyChanges_merge.resize(0);
-        }
+        // collect "zipper bottom" edge pairs, only consider these for now
+        std::vector<std::pair<int, int>> candCohEs;  // (cohI, forkVI)
         for (int cohI = 0; cohI < cohE.rows(); cohI++)
         {
             int forkVI = 0;
@@ -916,7 +1080,6 @@ namespace OptCuts
             }
             else
             {
-                // only consider "zipper bottom" edge pairs for now
                 continue;
             }
 
@@ -928,6 +1091,23 @@ namespace OptCuts
                 }
             }
 
+            candCohEs.emplace_back(cohI, forkVI);
+        }
+
+        // evaluate local energy decrease
+        // std::cout << "evaluate edge merge, " << candCohEs.size() << " candidate edge pairs." << std::endl;
+        // run in parallel, V is only read so that split queries can run alongside:
+        std::vector<char> feasible(candCohEs.size(), false);
+        std::vector<double> EwDecs(candCohEs.size(), -__DBL_MAX__);
+        std::vector<std::vector<int>> paths_p(candCohEs.size());
+        std::vector<Eigen::MatrixXd> newVertPoses_p(candCohEs.size());
+        std::vector<std::pair<double, double>> energyChanges_p(candCohEs.size());
+        tbb::parallel_for(0, (int)candCohEs.size(), 1, [&](int candI) {
+            const int cohI = candCohEs[candI].first;
+            const int forkVI = candCohEs[candI].second;
+            const int vI_merge0 = cohE(cohI, 1 - forkVI);
+            const int vI_merge1 = cohE(cohI, 3 - forkVI);
+
             // find incident triangles for inversion check and local energy decrease evaluation
             std::vector<int> triangles;
             int firstVertIncTriAmt = 0;
@@ -948,17 +1128,25 @@ namespace OptCuts
                 }
             }
 
-            Eigen::RowVector2d mergedPos = (V.row(cohE(cohI, 1 - forkVI)) + V.row(cohE(cohI, 3 - forkVI))) / 2.0;
-            const Eigen::RowVector2d backup0 = V.row(cohE(cohI, 1 - forkVI));
-            const Eigen::RowVector2d backup1 = V.row(cohE(cohI, 3 - forkVI));
-            V.row(cohE(cohI, 1 - forkVI)) = mergedPos;
-            V.row(cohE(cohI, 3 - forkVI)) = mergedPos;
-            if (checkInversion(true, triangles))
-            {
-                V.row(cohE(cohI, 1 - forkVI)) = backup0;
-                V.row(cohE(cohI, 3 - forkVI)) = backup1;
-            }
-            else
+            // inversion check of the incident triangles as if both vertices were at mergedPos
+            Eigen::RowVector2d mergedPos = (V.row(vI_merge0) + V.row(vI_merge1)) / 2.0;
+            auto vertPos = [&](int vI) -> Eigen::RowVector2d {
+                return (((vI == vI_merge0) || (vI == vI_merge1)) ? mergedPos : Eigen::RowVector2d(V.row(vI)));
+            };
+            auto noInversion = [&](void) {
+                for (const auto& triI : triangles)
+                {
+                    const Eigen::RowVector2d v0 = vertPos(F(triI, 0));
+                    const Eigen::RowVector2d e_u[2] = {vertPos(F(triI, 1)) - v0, vertPos(F(triI, 2)) - v0};
+                    if (e_u[0][0] * e_u[1][1] - e_u[0][1] * e_u[1][0] < 0.0)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            if (!noInversion())
             {
                 // project mergedPos to feasible set via Relaxation method for linear inequalities
 
@@ -968,13 +1156,13 @@ namespace OptCuts
                 for (int triII = 0; triII < triangles.size(); triII++)
                 {
                     int triI = triangles[triII];
-                    int vI_toMerge = ((triII < firstVertIncTriAmt) ? cohE(cohI, 1 - forkVI) : cohE(cohI, 3 - forkVI));
+                    int vI_toMerge = ((triII < firstVertIncTriAmt) ? vI_merge0 : vI_merge1);
                     for (int i = 0; i < 3; i++)
                     {
                         if (F(triI, i) == vI_toMerge)
                         {
-                            const Eigen::RowVector2d& v1 = V.row(F(triI, (i + 1) % 3));
-                            const Eigen::RowVector2d& v2 = V.row(F(triI, (i + 2) % 3));
+                            const Eigen::RowVector2d v1 = vertPos(F(triI, (i + 1) % 3));
+                            const Eigen::RowVector2d v2 = vertPos(F(triI, (i + 2) % 3));
                             Eigen::RowVector2d coef(v2[1] - v1[1], v1[0] - v2[0]);
                             inequalityConsMtr.conservativeResize(inequalityConsMtr.rows() + 1, 2);
                             inequalityConsMtr.row(inequalityConsMtr.rows() - 1) = coef / coef.norm();
@@ -1015,20 +1203,15 @@ namespace OptCuts
                     }
                 }
 
-                V.row(cohE(cohI, 1 - forkVI)) = mergedPos;
-                V.row(cohE(cohI, 3 - forkVI)) = mergedPos;
-                bool noInversion = checkInversion(true, triangles);
-                V.row(cohE(cohI, 1 - forkVI)) = backup0;
-                V.row(cohE(cohI, 3 - forkVI)) = backup1;
-                if (!noInversion)
+                if (!noInversion())
                 {
                     // because propagation is not at E_SD stationary, so it's possible to have no feasible region
-                    continue;
+                    return;
                 }
             }
 
             // optimize local distortion
-            std::vector<int> path;
+            std::vector<int>& path = paths_p[candI];
             if (forkVI)
             {
                 path.emplace_back(cohE(cohI, 0));
@@ -1041,26 +1224,40 @@ namespace OptCuts
                 path.emplace_back(cohE(cohI, 2));
                 path.emplace_back(cohE(cohI, 1));
             }
-            Eigen::MatrixXd newVertPos;
-            std::pair<double, double> energyChanges;
-            double localEwDec = computeLocalLDec(0, lambda, path, newVertPos, energyChanges, triangles, mergedPos);
+            EwDecs[candI] = computeLocalLDec(0, lambda, path, newVertPoses_p[candI], energyChanges_p[candI], triangles, mergedPos);
+            feasible[candI] = true;
+        });
+
+        // gather in cohE order so that results and tie-breaking do not depend on scheduling
+        localEwDec_max = -__DBL_MAX__;
+        if (!propagate)
+        {
+            context->paths_merge.resize(0);
+            context->newVertPoses_merge.resize(0);
+            context->energyChanges_merge.resize(0);
+        }
+        for (int candI = 0; candI < candCohEs.size(); candI++)
+        {
+            if (!feasible[candI])
+            {
+                continue;
+            }
+
             if (!propagate)
             {
-                paths_merge.emplace_back(path);
-                newVertPoses_merge.emplace_back(newVertPos);
-                energyChanges_merge.emplace_back(energyChanges);
+                context->paths_merge.emplace_back(paths_p[candI]);
+                context->newVertPoses_merge.emplace_back(newVertPoses_p[candI]);
+                context->energyChanges_merge.emplace_back(energyChanges_p[candI]);
             }
 
-            if (localEwDec > localEwDec_max)
+            if (EwDecs[candI] > localEwDec_max)
             {
-                localEwDec_max = localEwDec;
-                newVertPos_max = newVertPos;
-                path_max = path;
-                energyChanges_max = energyChanges;
+                localEwDec_max = EwDecs[candI];
+                newVertPos_max = newVertPoses_p[candI];
+                path_max = paths_p[candI];
+                energyChanges_max = energyChanges_p[candI];
             }
         }
-
-        timer_step.stop();
     }
 
     bool TriMesh::mergeEdge(double lambda, double EDecThres, bool propagate)
@@ -1069,16 +1266,21 @@ namespace OptCuts
         std::vector<int> path_max;
         Eigen::MatrixXd newVertPos_max;
         std::pair<double, double> energyChanges_max;
+        context->timer_step.start(8);
         queryMerge(lambda, propagate, localEwDec_max, path_max, newVertPos_max, energyChanges_max);
+        context->timer_step.stop();
 
+        lastTopoOpType = -1;
         // std::cout << "E_dec threshold = " << EDecThres << std::endl;
         if (localEwDec_max > EDecThres)
         {
+            lastTopoOpType = 2;
+            lastTopoOpPath = path_max;
+            lastTopoOpEwDec = localEwDec_max;
             // std::cout << "merge edge E_dec = " << localEwDec_max << std::endl;
             mergeBoundaryEdges(std::pair<int, int>(path_max[0], path_max[1]), std::pair<int, int>(path_max[1], path_max[2]), newVertPos_max.row(0));
-            logFile << "edge merged" << std::endl;
+            context->logFile << "edge merged\n";
 
-            computeFeatures();  // TODO: only update locally
             return true;
         }
         else
@@ -1099,16 +1301,34 @@ namespace OptCuts
         std::pair<double, double> energyChanes_split, energyChanes_merge;
         if (splitInterior)
         {
+            context->timer_step.start(7);
             querySplit(lambda_t, propagate, splitInterior, EwDec_max, path_max, newVertPos_max, energyChanes_split);
+            context->timer_step.stop();
         }
         else
         {
+            // boundary split and merge queries only read the mesh,
+            // evaluate them concurrently on the shared TBB thread pool
             double EwDec_max_split, EwDec_max_merge;
             std::vector<int> path_max_split, path_max_merge;
             Eigen::MatrixXd newVertPos_max_split, newVertPos_max_merge;
-            querySplit(lambda_t, propagate, splitInterior, EwDec_max_split, path_max_split, newVertPos_max_split, energyChanes_split);
-            queryMerge(lambda_t, propagate, EwDec_max_merge, path_max_merge, newVertPos_max_merge, energyChanes_merge);
-
+            double time_split = 0.0, time_merge = 0.0;
+            tbb::task_group queries;
+            queries.run([&] {
+                tbb::tick_count start = tbb::tick_count::now();
+                querySplit(lambda_t, propagate, splitInterior, EwDec_max_split, path_max_split, newVertPos_max_split, energyChanes_split);
+                time_split = (tbb::tick_count::now() - start).seconds();
+            });
+            queries.run([&] {
+                tbb::tick_count start = tbb::tick_count::now();
+                queryMerge(lambda_t, propagate, EwDec_max_merge, path_max_merge, newVertPos_max_merge, energyChanes_merge);
+                time_merge = (tbb::tick_count::now() - start).seconds();
+            });
+            queries.wait();
+            context->timer_step.add(6, time_split);
+            context->timer_step.add(8, time_merge);
+
+            // split wins ties, independent of which query finished first
             if (EwDec_max_merge > EwDec_max_split)
             {
                 isMerge = true;
@@ -1124,15 +1344,18 @@ namespace OptCuts
             }
         }
 
+        lastTopoOpType = -1;
         if (EwDec_max > EDecThres)
         {
+            lastTopoOpType = (isMerge ? 2 : static_cast<int>(splitInterior));
+            lastTopoOpPath = path_max;
+            lastTopoOpEwDec = EwDec_max;
             if (isMerge)
             {
                 // std::cout << "merge edge E_dec = " << EwDec_max << std::endl;
                 mergeBoundaryEdges(std::pair<int, int>(path_max[0], path_max[1]), std::pair<int, int>(path_max[1], path_max[2]),
                                    newVertPos_max.row(0));
-                logFile << "edge merged" << std::endl;
-                computeFeatures();  // TODO: only update locally
+                context->logFile << "edge merged\n";
             }
             else
             {
@@ -1141,7 +1364,7 @@ namespace OptCuts
                     // boundary split
                     // std::cout << "boundary split E_dec = " << EwDec_max << std::endl;
                     splitEdgeOnBoundary(std::pair<int, int>(path_max[0], path_max[1]), newVertPos_max);
-                    logFile << "boundary edge splitted" << std::endl;
+                    context->logFile << "boundary edge splitted\n";
                     // TODO: process fractail here!
                     updateFeatures();
                 }
@@ -1150,7 +1373,7 @@ namespace OptCuts
                     // interior split
                     // std::cout << "Interior split E_dec = " << EwDec_max << std::endl;
                     cutPath(path_max, true, 1, newVertPos_max);
-                    logFile << "interior edge splitted" << std::endl;
+                    context->logFile << "interior edge splitted\n";
                     fracTail.insert(path_max[0]);
                     fracTail.insert(path_max[2]);
                     curInteriorFracTails.first = path_max[0];
@@ -1269,147 +1492,40 @@ namespace OptCuts
         }
     }
 
-    // A utility function to find the vertex with minimum distance value, from
-    // the set of vertices not yet included in shortest path tree
-    int minDistance(const std::vector<double>& dist, const std::vector<bool>& sptSet)
-    {
-        // Initialize min value
-        double min = __DBL_MAX__;
-        int min_index = -1;
+    void TriMesh::farthestPointCut(int p_vI) { farthestPointCut(std::vector<int>(1, p_vI)); }
 
-        for (int v = 0; v < dist.size(); v++)
-        {
-            if ((!sptSet[v]) && (dist[v] <= min))
-            {
-                min = dist[v], min_index = v;
-            }
-        }
-
-        return min_index;
-    }
-
-    // Funtion that implements Dijkstra's single source shortest path algorithm
-    // for a graph represented using adjacency matrix representation
-    void dijkstra(const std::vector<std::map<int, double>>& graph, int src, std::vector<double>& dist, std::vector<int>& parent)
+    void TriMesh::farthestPointCut(const std::vector<int>& seeds)
     {
-        int nV = static_cast<int>(graph.size());
-
-        dist.resize(0);
-        dist.resize(nV, __DBL_MAX__);
-        // The output array.  dist[i] will hold the shortest
-        // distance from src to i
-
-        std::vector<bool> sptSet(nV, false);  // sptSet[i] will true if vertex i is included in shortest
-        // path tree or shortest distance from src to i is finalized
-
-        parent.resize(0);
-        parent.resize(nV, -1);
-
-        // Distance of source vertex from itself is always 0
-        dist[src] = 0.0;
-
-        // Find shortest path for all vertices
-        for (int count = 0; count + 1 < nV; count++)
-        {
-            // Pick the minimum distance vertex from the set of vertices not
-            // yet processed. u is always equal to src in first iteration.
-            int u = minDistance(dist, sptSet);
-
-            // Mark the picked vertex as processed
-            sptSet[u] = true;
-
-            for (const auto v : graph[u])
-            {
-                // Update dist[v] only if is not in sptSet, there is an edge from
-                // u to v, and total weight of path from src to  v through u is
-                // smaller than current value of dist[v]
-                if ((!sptSet[v.first]) && (dist[u] != __DBL_MAX__) && (dist[u] + v.second < dist[v.first]))
-                {
-                    dist[v.first] = dist[u] + v.second;
-                    parent[v.first] = u;
-                }
-            }
-        }
-    }
-
-    int getFarthestPoint(const std::vector<std::map<int, double>>& graph, int src)
-    {
-        int nV = static_cast<int>(graph.size());
-        std::vector<double> dist;
-        std::vector<int> parent;
-        dijkstra(graph, src, dist, parent);
-
-        double maxDist = 0.0;
-        int vI_maxDist = -1;
-        for (int vI = 0; vI < nV; vI++)
-        {
-            if (dist[vI] > maxDist)
-            {
-                maxDist = dist[vI];
-                vI_maxDist = vI;
-            }
-        }
-        assert(vI_maxDist >= 0);
-        return vI_maxDist;
-    }
-
-    void getFarthestPointPath(const std::vector<std::map<int, double>>& graph, int src, std::vector<int>& path)
-    {
-        int nV = static_cast<int>(graph.size());
-        std::vector<double> dist;
-        std::vector<int> parent;
-        dijkstra(graph, src, dist, parent);
+        assert(vNeighbor.size() == V_rest.rows());
 
-        double maxDist = 0.0;
-        int vI_maxDist = -1;
-        for (int vI = 0; vI < nV; vI++)
+        // for each seed, cut the shortest path from its farthest point to the point farthest from that,
+        // the seeds are in different components so their queries are independent
+        const MeshGraph graph(vNeighbor, V_rest);
+        std::vector<std::vector<int>> paths;
+        graph.farthestPaths(seeds, paths);
+        std::vector<int> pathStarts(seeds.size());
+        for (int seedI = 0; seedI < seeds.size(); seedI++)
         {
-            if (dist[vI] > maxDist)
-            {
-                maxDist = dist[vI];
-                vI_maxDist = vI;
-            }
-        }
-        assert(vI_maxDist >= 0);
-        path.resize(0);
-        while (vI_maxDist >= 0)
-        {
-            path.emplace_back(vI_maxDist);
-            vI_maxDist = parent[vI_maxDist];
+            assert(paths[seedI].size() >= 2);
+            pathStarts[seedI] = paths[seedI].back();
         }
-        std::reverse(path.begin(), path.end());
-    }
-
-    void TriMesh::farthestPointCut(int p_vI)
-    {
-        assert(vNeighbor.size() == V_rest.rows());
+        graph.farthestPaths(pathStarts, paths);
 
-        std::vector<std::map<int, double>> graph(vNeighbor.size());
-        for (int vI = 0; vI < vNeighbor.size(); vI++)
+        // cutting only appends vertices, the paths of the other components stay valid
+        bool makeCoh = true;
+        for (const auto& path : paths)
         {
-            for (const auto nbI : vNeighbor[vI])
+            if (!makeCoh)
             {
-                if (nbI > vI)
+                for (int pI = 0; pI + 1 < path.size(); pI++)
                 {
-                    graph[nbI][vI] = graph[vI][nbI] = (V_rest.row(vI) - V_rest.row(nbI)).norm();
+                    initSeamLen += (V_rest.row(path[pI]) - V_rest.row(path[pI + 1])).norm();
                 }
             }
-        }
-
-        std::vector<int> path;
-        getFarthestPointPath(graph, getFarthestPoint(graph, p_vI), path);
 
-        bool makeCoh = true;
-        if (!makeCoh)
-        {
-            for (int pI = 0; pI + 1 < path.size(); pI++)
-            {
-                initSeamLen += (V_rest.row(path[pI]) - V_rest.row(path[pI + 1])).norm();
-            }
+            cutPath(path, makeCoh);
         }
 
-        cutPath(path, makeCoh);
-
         if (makeCoh)
         {
             initSeams = cohE;
@@ -1500,48 +1616,18 @@ namespace OptCuts
         }
         assert(vI_extremal >= 0);
 
-        // construct mesh graph
+        // find closest point on boundary, the search stops once it is settled
         assert(vNeighbor.size() == V_rest.rows());
-        std::vector<std::map<int, double>> graph(vNeighbor.size());
-        for (int vI = 0; vI < vNeighbor.size(); vI++)
-        {
-            for (const auto nbI : vNeighbor[vI])
-            {
-                if (nbI > vI)
-                {
-                    graph[nbI][vI] = graph[vI][nbI] = (V_rest.row(vI) - V_rest.row(nbI)).norm();
-                }
-            }
-        }
-
-        // find closest point on boundary
-        int nV = static_cast<int>(graph.size());
+        const MeshGraph graph(vNeighbor, V_rest);
         std::vector<double> dist;
         std::vector<int> parent;
-        dijkstra(graph, vI_extremal, dist, parent);
-        double minDistToBound = __DBL_MAX__;
-        int vI_minDistToBound = -1;
-        for (int vI = 0; vI < nV; vI++)
-        {
-            if (isBoundaryVert(vI))
-            {
-                if (dist[vI] < minDistToBound)
-                {
-                    minDistToBound = dist[vI];
-                    vI_minDistToBound = vI;
-                }
-            }
-        }
+        const int vI_minDistToBound = graph.shortestPaths(std::vector<int>(1, vI_extremal), dist, parent,
+                                                          [this](int vI) { return isBoundaryVert(vI); });
         assert((vI_minDistToBound >= 0) && "No boundary on the mesh!");
 
         // find shortest path to closest point on boundary
         std::vector<int> path;
-        while (vI_minDistToBound >= 0)
-        {
-            path.emplace_back(vI_minDistToBound);
-            vI_minDistToBound = parent[vI_minDistToBound];
-        }
-        std::reverse(path.begin(), path.end());
+        MeshGraph::tracePath(parent, vI_minDistToBound, path);
 
         cutPath(path, true);
     }
@@ -1650,8 +1736,11 @@ namespace OptCuts
             {
                 V.row(nV) = V.row(path[1]);
             }
+            std::vector<Eigen::RowVector3i> triVInd_old;
+            triVInd_old.reserve(tri_left.size());
             for (const auto triI : tri_left)
             {
+                triVInd_old.emplace_back(F.row(triI));
                 for (int vI = 0; vI < 3; vI++)
                 {
                     if (F(triI, vI) == path[1])
@@ -1669,7 +1758,7 @@ namespace OptCuts
                 cohE.row(nCoh + 1) << path[2], nV, path[2], path[1];
             }
 
-            computeFeatures();  // TODO: only update locally
+            updateFeatures(tri_left, triVInd_old);
 
             for (int vI = 2; vI + 1 < path.size(); vI++)
             {
@@ -1691,6 +1780,170 @@ namespace OptCuts
         return cuts_made;
     }
 
+    int TriMesh::cutPaths(const std::vector<std::vector<int>>& paths, bool makeCoh)
+    {
+        // interior edges on the paths, as sorted vertex index pairs
+        std::vector<std::pair<int, int>> seamEdges;
+        for (const auto& path : paths)
+        {
+            for (int pI = 0; pI + 1 < path.size(); pI++)
+            {
+                seamEdges.emplace_back(std::min(path[pI], path[pI + 1]), std::max(path[pI], path[pI + 1]));
+            }
+        }
+        std::sort(seamEdges.begin(), seamEdges.end());
+        seamEdges.erase(std::unique(seamEdges.begin(), seamEdges.end()), seamEdges.end());
+
+        // the triangle corners around a vertex that are connected through edges not on the paths
+        // stay on the same vertex, all others get a duplicated vertex,
+        // found with a union-find over the corners
+        auto cornerOf = [this](int triI, int vI) {
+            for (int i = 0; i < 3; i++)
+            {
+                if (F(triI, i) == vI)
+                {
+                    return triI * 3 + i;
+                }
+            }
+            assert(0 && "vertex not in triangle!");
+            return -1;
+        };
+        std::vector<int> cornerParent(F.rows() * 3);
+        for (int cI = 0; cI < cornerParent.size(); cI++)
+        {
+            cornerParent[cI] = cI;
+        }
+        auto findRoot = [&cornerParent](int cI) {
+            while (cornerParent[cI] != cI)
+            {
+                cornerParent[cI] = cornerParent[cornerParent[cI]];
+                cI = cornerParent[cI];
+            }
+            return cI;
+        };
+
+        int cuts_made = 0;
+        std::vector<std::array<int, 4>> cohCorners;
+        for (int triI = 0; triI < F.rows(); triI++)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                const int vs = F(triI, i), ve = F(triI, (i + 1) % 3);
+                if (vs > ve)
+                {
+                    // each interior edge once
+                    continue;
+                }
+                const auto finder = edge2Tri.find(std::pair<int, int>(ve, vs));
+                if (finder == edge2Tri.end())
+                {
+                    continue;
+                }
+
+                const int cs = triI * 3 + i, ce = triI * 3 + (i + 1) % 3;
+                const int cs_opp = cornerOf(finder->second, vs), ce_opp = cornerOf(finder->second, ve);
+                if (std::binary_search(seamEdges.begin(), seamEdges.end(), std::pair<int, int>(vs, ve)))
+                {
+                    cohCorners.push_back({{cs, ce, cs_opp, ce_opp}});
+                    ++cuts_made;
+                }
+                else
+                {
+                    cornerParent[findRoot(cs)] = findRoot(cs_opp);
+                    cornerParent[findRoot(ce)] = findRoot(ce_opp);
+                }
+            }
+        }
+        if (!cuts_made)
+        {
+            return 0;
+        }
+
+        // existing cohesive edges are on the boundary, locate them by their triangle corners before relabeling
+        std::vector<int> cohECorners(cohE.rows() * 4, -1);
+        for (int cohI = 0; cohI < cohE.rows(); cohI++)
+        {
+            for (int sideI = 0; sideI < 4; sideI += 2)
+            {
+                // (0, 1) and (3, 2) are directed edges of the triangles on the two sides
+                const int vs = cohE(cohI, sideI ? 3 : 0), ve = cohE(cohI, sideI ? 2 : 1);
+                const auto finder = edge2Tri.find(std::pair<int, int>(vs, ve));
+                if ((vs >= 0) && (ve >= 0) && (finder != edge2Tri.end()))
+                {
+                    cohECorners[cohI * 4 + sideI] = cornerOf(finder->second, cohE(cohI, sideI));
+                    cohECorners[cohI * 4 + sideI + 1] = cornerOf(finder->second, cohE(cohI, sideI + 1));
+                }
+            }
+        }
+
+        // the first corner group of each vertex keeps its index
+        const int nV = static_cast<int>(V_rest.rows());
+        std::vector<int> rootVert(cornerParent.size(), -1);
+        std::vector<bool> vertTaken(nV, false);
+        std::vector<int> vertSource;
+        for (int cI = 0; cI < cornerParent.size(); cI++)
+        {
+            const int rootI = findRoot(cI);
+            if (rootVert[rootI] < 0)
+            {
+                const int vI = F(cI / 3, cI % 3);
+                if (!vertTaken[vI])
+                {
+                    vertTaken[vI] = true;
+                    rootVert[rootI] = vI;
+                }
+                else
+                {
+                    rootVert[rootI] = nV + static_cast<int>(vertSource.size());
+                    vertSource.emplace_back(vI);
+                }
+            }
+        }
+
+        V_rest.conservativeResize(nV + vertSource.size(), 3);
+        V.conservativeResize(nV + vertSource.size(), 2);
+        vertWeight.conservativeResize(nV + vertSource.size());
+        for (int vI = 0; vI < vertSource.size(); vI++)
+        {
+            V_rest.row(nV + vI) = V_rest.row(vertSource[vI]);
+            V.row(nV + vI) = V.row(vertSource[vI]);
+            vertWeight[nV + vI] = vertWeight[vertSource[vI]];
+        }
+        for (int cI = 0; cI < cornerParent.size(); cI++)
+        {
+            F(cI / 3, cI % 3) = rootVert[findRoot(cI)];
+        }
+
+        for (int cohI = 0; cohI < cohE.rows(); cohI++)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                const int cI = cohECorners[cohI * 4 + i];
+                if (cI >= 0)
+                {
+                    cohE(cohI, i) = F(cI / 3, cI % 3);
+                }
+            }
+        }
+        if (makeCoh)
+        {
+            int nCoh = static_cast<int>(cohE.rows());
+            cohE.conservativeResize(nCoh + cohCorners.size(), 4);
+            for (const auto& corners : cohCorners)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    cohE(nCoh, i) = F(corners[i] / 3, corners[i] % 3);
+                }
+                nCoh++;
+            }
+        }
+
+        computeFeatures();
+
+        return cuts_made;
+    }
+
     void TriMesh::computeSeamScore(Eigen::VectorXd& seamScore) const
     {
         seamScore.resize(cohE.rows());
@@ -1882,11 +2135,11 @@ namespace OptCuts
         const double dbArea = e_u[0][0] * e_u[1][1] - e_u[0][1] * e_u[1][0];
         if (dbArea < eps)
         {
-            if (!mute)
+            if ((!mute) && context)
             {
                 // std::cout << "***Element inversion detected: " << dbArea << " < " << eps << std::endl;
                 // std::cout << "mesh triangle count: " << F.rows() << std::endl;
-                logFile << "***Element inversion detected: " << dbArea << " < " << eps << std::endl;
+                context->logFile << "***Element inversion detected: " << dbArea << " < " << eps << "\n";
             }
             return false;
         }
@@ -1965,19 +2218,65 @@ namespace OptCuts
 
     void TriMesh::save(const std::string& filePath) const { save(filePath, V_rest, F, V); }
 
+    void TriMesh::saveState(std::ostream& out) const
+    {
+        BinaryIO::writeMatrix(out, V_rest);
+        BinaryIO::writeMatrix(out, V);
+        BinaryIO::writeMatrix(out, F);
+        BinaryIO::writeMatrix(out, cohE);
+        BinaryIO::writeMatrix(out, initSeams);
+        BinaryIO::writeMatrix(out, vertWeight);
+        BinaryIO::writeSet(out, fixedVert);
+        BinaryIO::writeSet(out, fracTail);
+        BinaryIO::write(out, curFracTail);
+        BinaryIO::write(out, curInteriorFracTails.first);
+        BinaryIO::write(out, curInteriorFracTails.second);
+        BinaryIO::write(out, initSeamLen);
+        BinaryIO::write(out, areaThres_AM);
+    }
+
+    bool TriMesh::loadState(std::istream& in)
+    {
+        std::set<int> p_fracTail;
+        if (!(BinaryIO::readMatrix(in, V_rest) && BinaryIO::readMatrix(in, V) && BinaryIO::readMatrix(in, F) && BinaryIO::readMatrix(in, cohE) &&
+              BinaryIO::readMatrix(in, initSeams) && BinaryIO::readMatrix(in, vertWeight) && BinaryIO::readSet(in, fixedVert) &&
+              BinaryIO::readSet(in, p_fracTail) && BinaryIO::read(in, curFracTail) && BinaryIO::read(in, curInteriorFracTails.first) &&
+              BinaryIO::read(in, curInteriorFracTails.second) && BinaryIO::read(in, initSeamLen) && BinaryIO::read(in, areaThres_AM)))
+        {
+            return false;
+        }
+        if ((V.rows() != V_rest.rows()) || (V.cols() != 2) || (V_rest.cols() != 3) || (F.cols() != 3) ||
+            ((F.size() > 0) && ((F.minCoeff() < 0) || (F.maxCoeff() >= V.rows()))) || (vertWeight.size() != V.rows()))
+        {
+            return false;
+        }
+
+        scaffold = NULL;
+        computeFeatures();
+        fracTail = p_fracTail;  // computeFeatures() only recovers the tails of cohesive edges
+        return true;
+    }
+
     void TriMesh::saveAsMesh(const std::string& filePath, bool scaleUV) const
     {
-        std::vector<int> dupVI2GroupI(V.rows());
-        std::vector<std::set<int>> meshVGroup(V.rows());
-        std::vector<int> dupVI2GroupI_3D(V_rest.rows());
-        std::vector<std::set<int>> meshVGroup_3D(V_rest.rows());
-        for (int dupI = 0; dupI < V.rows(); dupI++)
+        assert(V.rows() == V_rest.rows());
+
+        // weld the duplicated vertices in 3D across the interior cohesive edges,
+        // the group of the first vertex of an edge absorbs the other one so that
+        // each group is rooted at the same vertex as it would be by merging vertex sets
+        std::vector<int> dupVParent(V_rest.rows());
+        for (int dupI = 0; dupI < dupVParent.size(); dupI++)
         {
-            dupVI2GroupI[dupI] = dupI;
-            meshVGroup[dupI].insert(dupI);
-            dupVI2GroupI_3D[dupI] = dupI;
-            meshVGroup_3D[dupI].insert(dupI);
+            dupVParent[dupI] = dupI;
         }
+        auto findRoot = [&dupVParent](int vI) {
+            while (dupVParent[vI] != vI)
+            {
+                dupVParent[vI] = dupVParent[dupVParent[vI]];
+                vI = dupVParent[vI];
+            }
+            return vI;
+        };
         for (int cohI = 0; cohI < cohE.rows(); cohI++)
         {
             if (boundaryEdge[cohI])
@@ -1987,116 +2286,72 @@ namespace OptCuts
 
             for (int pI = 0; pI < 2; pI++)
             {
-                int groupI0_3D = dupVI2GroupI_3D[cohE(cohI, 0 + pI)];
-                int groupI2_3D = dupVI2GroupI_3D[cohE(cohI, 2 + pI)];
-                if (groupI0_3D != groupI2_3D)
+                const int rootI0 = findRoot(cohE(cohI, 0 + pI));
+                const int rootI2 = findRoot(cohE(cohI, 2 + pI));
+                if (rootI0 != rootI2)
                 {
-                    for (const auto& vI : meshVGroup_3D[groupI2_3D])
-                    {
-                        dupVI2GroupI_3D[vI] = groupI0_3D;
-                        meshVGroup_3D[groupI0_3D].insert(vI);
-                    }
-                    meshVGroup_3D[groupI2_3D].clear();
-                }
-
-                // this is only for gluing the triangle soup
-                //                if((V.row(cohE(cohI, 0 + pI)) - V.row(cohE(cohI, 2 + pI))).norm() / avgEdgeLen > thres) {
-                continue;
-                //                }
-
-                int groupI0 = dupVI2GroupI[cohE(cohI, 0 + pI)];
-                int groupI2 = dupVI2GroupI[cohE(cohI, 2 + pI)];
-                if (groupI0 != groupI2)
-                {
-                    for (const auto& vI : meshVGroup[groupI2])
-                    {
-                        dupVI2GroupI[vI] = groupI0;
-                        meshVGroup[groupI0].insert(vI);
-                    }
-                    meshVGroup[groupI2].clear();
+                    dupVParent[rootI2] = rootI0;
                 }
             }
         }
+        // the UV coordinates are not glued, as the triangle soup may be torn apart in UV space
+        Eigen::MatrixXd UV_mesh = V;
+        const Eigen::MatrixXi& FUV_mesh = F;
 
-        int meshVAmt = 0;
-        for (int gI = 0; gI < meshVGroup.size(); gI++)
-        {
-            if (!meshVGroup[gI].empty())
+        // compact the roots in ascending order and gather the members of each group,
+        // also in ascending order so that the averaged positions do not depend on the threads
+        std::vector<int> dupVI2GroupI(V_rest.rows());
+        tbb::parallel_for(0, (int)dupVI2GroupI.size(), 1, [&](int dupI) {
+            int rootI = dupI;
+            while (dupVParent[rootI] != rootI)
             {
-                meshVAmt++;
+                rootI = dupVParent[rootI];
             }
-        }
-        std::vector<int> groupI2meshVI(meshVGroup.size(), -1);
-        Eigen::MatrixXd UV_mesh;
-        UV_mesh.resize(meshVAmt, 2);
-
-        int meshVAmt_3D = 0;
-        for (int gI = 0; gI < meshVGroup_3D.size(); gI++)
+            dupVI2GroupI[dupI] = rootI;
+        });
+        std::vector<int> groupI2meshVI(V_rest.rows(), -1);
+        std::vector<int> meshVGroupStart(1, 0);
+        for (int dupI = 0; dupI < dupVI2GroupI.size(); dupI++)
         {
-            if (!meshVGroup_3D[gI].empty())
+            if (dupVI2GroupI[dupI] == dupI)
             {
-                meshVAmt_3D++;
+                groupI2meshVI[dupI] = meshVGroupStart.size() - 1;
+                meshVGroupStart.emplace_back(0);
             }
         }
-        std::vector<int> groupI2meshVI_3D(meshVGroup_3D.size(), -1);
-        Eigen::MatrixXd V_mesh;
-        V_mesh.resize(meshVAmt_3D, 3);
-
-        int nextVI = 0;
-        for (int gI = 0; gI < meshVGroup.size(); gI++)
+        const int meshVAmt_3D = meshVGroupStart.size() - 1;
+        for (int dupI = 0; dupI < dupVI2GroupI.size(); dupI++)
         {
-            if (meshVGroup[gI].empty())
-            {
-                continue;
-            }
-
-            groupI2meshVI[gI] = nextVI;
-            UV_mesh.row(nextVI) = Eigen::RowVector2d::Zero();
-            for (const auto dupVI : meshVGroup[gI])
-            {
-                UV_mesh.row(nextVI) += V.row(dupVI);
-            }
-            UV_mesh.row(nextVI) /= meshVGroup[gI].size();
-            nextVI++;
+            meshVGroupStart[groupI2meshVI[dupVI2GroupI[dupI]] + 1]++;
         }
-        int nextVI_3D = 0;
-        for (int gI = 0; gI < meshVGroup_3D.size(); gI++)
+        for (int meshVI = 0; meshVI < meshVAmt_3D; meshVI++)
         {
-            if (meshVGroup_3D[gI].empty())
-            {
-                continue;
-            }
+            meshVGroupStart[meshVI + 1] += meshVGroupStart[meshVI];
+        }
+        std::vector<int> meshVGroup(dupVI2GroupI.size());
+        std::vector<int> nextMemberI(meshVGroupStart.begin(), meshVGroupStart.end() - 1);
+        for (int dupI = 0; dupI < dupVI2GroupI.size(); dupI++)
+        {
+            meshVGroup[nextMemberI[groupI2meshVI[dupVI2GroupI[dupI]]]++] = dupI;
+        }
 
-            groupI2meshVI_3D[gI] = nextVI_3D;
-            V_mesh.row(nextVI_3D) = Eigen::RowVector3d::Zero();
-            for (const auto dupVI : meshVGroup_3D[gI])
+        Eigen::MatrixXd V_mesh(meshVAmt_3D, 3);
+        tbb::parallel_for(0, meshVAmt_3D, 1, [&](int meshVI) {
+            Eigen::RowVector3d pos = Eigen::RowVector3d::Zero();
+            for (int memberI = meshVGroupStart[meshVI]; memberI < meshVGroupStart[meshVI + 1]; memberI++)
             {
-                V_mesh.row(nextVI_3D) += V_rest.row(dupVI);
+                pos += V_rest.row(meshVGroup[memberI]);
             }
-            V_mesh.row(nextVI_3D) /= meshVGroup_3D[gI].size();
-            nextVI_3D++;
-        }
+            V_mesh.row(meshVI) = pos / (meshVGroupStart[meshVI + 1] - meshVGroupStart[meshVI]);
+        });
 
-        Eigen::MatrixXi F_mesh, FUV_mesh;
-        F_mesh.resize(F.rows(), 3);
-        FUV_mesh.resize(F.rows(), 3);
-        for (int triI = 0; triI < F.rows(); triI++)
-        {
+        Eigen::MatrixXi F_mesh(F.rows(), 3);
+        tbb::parallel_for(0, (int)F.rows(), 1, [&](int triI) {
             for (int vI = 0; vI < 3; vI++)
             {
-                int groupI = dupVI2GroupI[F(triI, vI)];
-                assert(groupI >= 0);
-                int meshVI = groupI2meshVI[groupI];
-                assert(meshVI >= 0);
-                FUV_mesh(triI, vI) = meshVI;
-
-                int groupI_3D = dupVI2GroupI_3D[F(triI, vI)];
-                assert(groupI_3D >= 0);
-                int meshVI_3D = groupI2meshVI_3D[groupI_3D];
-                assert(meshVI_3D >= 0);
-                F_mesh(triI, vI) = meshVI_3D;
+                F_mesh(triI, vI) = groupI2meshVI[dupVI2GroupI[F(triI, vI)]];
             }
-        }
+        });
 
         if (scaleUV)
         {
@@ -2119,22 +2374,8 @@ namespace OptCuts
 
     void TriMesh::saveAsMesh(const std::string& filePath, const Eigen::MatrixXi& F0, bool scaleUV) const
     {
-        assert(F0.rows() == F.rows());
-        assert(F0.cols() == 3);
-
         Eigen::MatrixXd V_mesh;
-        for (int fI = 0; fI < F0.rows(); ++fI)
-        {
-            for (int localVI = 0; localVI < 3; ++localVI)
-            {
-                int vI = F0(fI, localVI);
-                if (vI >= V_mesh.rows())
-                {
-                    V_mesh.conservativeResize(vI + 1, 3);
-                }
-                V_mesh.row(vI) = V_rest.row(F(fI, localVI));
-            }
-        }
+        computeMeshVert(F0, V_mesh);
 
         Eigen::MatrixXd UV_mesh = V;
         if (scaleUV)
@@ -2156,6 +2397,41 @@ namespace OptCuts
         save(filePath, V_mesh, F0, UV_mesh, F);
     }
 
+    void TriMesh::saveAsBinaryMesh(const std::string& filePath, const Eigen::MatrixXi& F0,
+                                   const std::map<std::string, double>& meta, bool compress) const
+    {
+        BinaryMesh::Result result;
+        getBinaryMesh(F0, meta, result);
+        BinaryMesh::write(filePath, result, compress);
+    }
+
+    void TriMesh::getBinaryMesh(const Eigen::MatrixXi& F0, const std::map<std::string, double>& meta,
+                                BinaryMesh::Result& result) const
+    {
+        computeMeshVert(F0, result.V);
+        result.F = F0;
+        result.UV = V;
+        result.FUV = F;
+        result.cohE = cohE;
+        igl::facet_components(F, result.chartId);
+        result.meta = meta;
+    }
+
+    void TriMesh::computeMeshVert(const Eigen::MatrixXi& F0, Eigen::MatrixXd& V_mesh) const
+    {
+        assert(F0.rows() == F.rows());
+        assert(F0.cols() == 3);
+
+        V_mesh.resize((F0.size() > 0) ? (F0.maxCoeff() + 1) : 0, 3);
+        for (int fI = 0; fI < F0.rows(); ++fI)
+        {
+            for (int localVI = 0; localVI < 3; ++localVI)
+            {
+                V_mesh.row(F0(fI, localVI)) = V_rest.row(F(fI, localVI));
+            }
+        }
+    }
+
     bool TriMesh::findBoundaryEdge(int vI, const std::pair<int, int>& startEdge, std::pair<int, int>& boundaryEdge)
     {
         auto finder = edge2Tri.find(startEdge);
@@ -2308,6 +2584,7 @@ namespace OptCuts
                                      std::pair<double, double>& energyChanges_max, const std::vector<int>& incTris,
                                      const Eigen::RowVector2d& initMergedPos) const
     {
+        OPTCUTS_PROFILE_ZONE("localSolve");
         if (!path_max.empty())
         {
             // merge query
@@ -2424,7 +2701,7 @@ namespace OptCuts
             if (umbrella.size() > 10)
             {
                 // std::cout << "large degree vert, " << umbrella.size() << " incident tris" << std::endl;
-                logFile << "large degree vert, " << umbrella.size() << " incident tris" << std::endl;
+                context->logFile << "large degree vert, " << umbrella.size() << " incident tris\n";
             }
 
             path_max.resize(3);
@@ -2600,7 +2877,7 @@ namespace OptCuts
         // conduct optimization on local mesh
         std::vector<OptCuts::Energy*> energyTerms(1, &SD);
         std::vector<double> energyParams(1, 1.0);
-        Optimizer optimizer(localMesh, energyTerms, energyParams, 0, true, isBijective, UV_bnds, E, bnd, true);
+        Optimizer optimizer(*context, localMesh, energyTerms, energyParams, 0, true, isBijective, UV_bnds, E, bnd, true);
         optimizer.precompute();
         optimizer.setRelGL2Tol(1.0e-6);
         optimizer.solve(maxIter);  // do not output, the other part
@@ -2731,7 +3008,7 @@ namespace OptCuts
         // conduct optimization on local mesh
         std::vector<OptCuts::Energy*> energyTerms(1, &SD);
         std::vector<double> energyParams(1, 1.0);
-        Optimizer optimizer(localMesh, energyTerms, energyParams, 0, true, isBijective, UV_bnds, E, bnd, true);
+        Optimizer optimizer(*context, localMesh, energyTerms, energyParams, 0, true, isBijective, UV_bnds, E, bnd, true);
         optimizer.precompute();
         optimizer.setRelGL2Tol(1.0e-6);
         optimizer.solve(maxIter);  // do not output, the other part
@@ -3027,7 +3304,7 @@ namespace OptCuts
         // conduct optimization on local mesh
         std::vector<OptCuts::Energy*> energyTerms(1, &SD);
         std::vector<double> energyParams(1, 1.0);
-        Optimizer optimizer(localMesh, energyTerms, energyParams, 0, true, !!scaffold, UV_bnds, E, bnd, true);
+        Optimizer optimizer(*context, localMesh, energyTerms, energyParams, 0, true, !!scaffold, UV_bnds, E, bnd, true);
         optimizer.precompute();
         optimizer.setRelGL2Tol(1.0e-6);
         optimizer.solve(maxIter);
@@ -3251,8 +3528,10 @@ namespace OptCuts
             {
                 cohE(-CEIfinder->second - 1, 3) = nV;
             }
-            cohEIndex[std::pair<int, int>(nV, boundaryEdge[1].second)] = CEIfinder->second;
-            cohEIndex.erase(CEIfinder);
+            // insertion may rehash, so erase through the key afterwards
+            const int cohI = CEIfinder->second;
+            cohEIndex[std::pair<int, int>(nV, boundaryEdge[1].second)] = cohI;
+            cohEIndex.erase(boundaryEdge[1]);
         }
 
         if (duplicateBoth)
@@ -3320,8 +3599,9 @@ namespace OptCuts
                 {
                     cohE(-CEIfinder->second - 1, 3) = nV;
                 }
-                cohEIndex[std::pair<int, int>(nV, boundaryEdge[0].second)] = CEIfinder->second;
-                cohEIndex.erase(CEIfinder);
+                const int cohI = CEIfinder->second;
+                cohEIndex[std::pair<int, int>(nV, boundaryEdge[0].second)] = cohI;
+                cohEIndex.erase(boundaryEdge[0]);
             }
         }
     }
@@ -3360,26 +3640,25 @@ namespace OptCuts
         vertWeight.conservativeResize(vBackI);
         V.conservativeResize(vBackI, 2);
 
-        //        for(const auto& nbI : vNeighbor[edge1.second]) {
-        //            std::pair<int, int> edgeToFind[2] = {
-        //                std::pair<int, int>(edge1.second, nbI),
-        //                std::pair<int, int>(nbI, edge1.second)
-        //            };
-        //            for(int eI = 0; eI < 2; eI++) {
-        //                auto edgeTri = edge2Tri.find(edgeToFind[eI]);
-        //                if(edgeTri != edge2Tri.end()) {
-        //                    for(int vI = 0; vI < 3; vI++) {
-        //                        if(F(edgeTri->second, vI) == edge1.second) {
-        //                            F(edgeTri->second, vI) = edge0.first;
-        //                            break;
-        //                        }
-        //                    }
-        //                }
-        //            }
-        //        }
-
-        for (int triI = 0; triI < F.rows(); triI++)
+        // locate the triangles to relabel through the indices, which are still valid here
+        std::set<int> triSet;
+        for (int vI : {edge1.second, vBackI})
+        {
+            for (const auto& nbVI : vNeighbor[vI])
+            {
+                auto finder = edge2Tri.find(std::pair<int, int>(vI, nbVI));
+                if (finder != edge2Tri.end())
+                {
+                    triSet.insert(finder->second);
+                }
+            }
+        }
+        const std::vector<int> triangles(triSet.begin(), triSet.end());
+        std::vector<Eigen::RowVector3i> triVInd_old;
+        triVInd_old.reserve(triangles.size());
+        for (const auto& triI : triangles)
         {
+            triVInd_old.emplace_back(F.row(triI));
             for (int vI = 0; vI < 3; vI++)
             {
                 if (F(triI, vI) == edge1.second)
@@ -3388,11 +3667,7 @@ namespace OptCuts
                     break;
                 }
             }
-        }
-
-        if (edge1.second < vBackI)
-        {
-            for (int triI = 0; triI < F.rows(); triI++)
+            if (edge1.second < vBackI)
             {
                 for (int vI = 0; vI < 3; vI++)
                 {
@@ -3402,24 +3677,6 @@ namespace OptCuts
                     }
                 }
             }
-            //            // not valid because vNeighbor is not updated
-            //            for(const auto& nbI : vNeighbor[vBackI]) {
-            //                std::pair<int, int> edgeToFind[2] = {
-            //                    std::pair<int, int>(vBackI, nbI),
-            //                    std::pair<int, int>(nbI, vBackI)
-            //                };
-            //                for(int eI = 0; eI < 2; eI++) {
-            //                    auto edgeTri = edge2Tri.find(edgeToFind[eI]);
-            //                    if(edgeTri != edge2Tri.end()) {
-            //                        for(int vI = 0; vI < 3; vI++) {
-            //                            if(F(edgeTri->second, vI) == vBackI) {
-            //                                F(edgeTri->second, vI) = edge1.second;
-            //                                break;
-            //                            }
-            //                        }
-            //                    }
-            //                }
-            //            }
         }
 
         auto cohEFinder = cohEIndex.find(edge0);
@@ -3492,7 +3749,7 @@ namespace OptCuts
             }
         }
 
-        // TODO: locally update edge2Tri, vNeighbor, cohEIndex
+        updateFeatures(triangles, triVInd_old);
     }
 
 }  // namespace OptCuts
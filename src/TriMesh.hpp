@@ -8,10 +8,14 @@
 #ifndef TriMesh_hpp
 #define TriMesh_hpp
 
+#include "EdgeHashMap.hpp"
+
 #include <Eigen/Eigen>
 
+#include <map>
 #include <set>
 #include <array>
+#include <iostream>
 
 namespace OptCuts{
     
@@ -21,6 +25,10 @@ namespace OptCuts{
         P_CYLINDER
     };
     class Scaffold;
+    class RunContext;
+    namespace BinaryMesh {
+        struct Result;
+    }
     
     // duplicate the vertices and edges of a mesh to separate its triangles,
     // adjacent triangles in the original mesh will have a cohesive edge structure to
@@ -35,12 +43,14 @@ namespace OptCuts{
         
     public:
         const Scaffold* scaffold = NULL;
+        RunContext* context = NULL; // set by the Optimizer, needed by the topology queries and operations
         double areaThres_AM; // for preventing degeneracy of air mesh triangles
         
     public: // owned features
         Eigen::VectorXi boundaryEdge; // 1: boundary edge, 0: interior edge
         Eigen::VectorXd edgeLen; // cohesive edge rest length, used as weights
-        Eigen::SparseMatrix<double> LaplacianMtr; // 2 * V.rows() wide
+        Eigen::SparseMatrix<double> LaplacianMtr; // 2 * V.rows() wide, use getLaplacianMtr() after topology changes
+        bool LaplacianMtrOutdated = false;
         Eigen::VectorXd triArea; // triangle rest area
         Eigen::MatrixXd triNormal;
         double surfaceArea;
@@ -54,19 +64,26 @@ namespace OptCuts{
         double virtualRadius;
         std::vector<std::set<std::pair<int, int>>> validSplit;
         std::set<int> fixedVert; // for linear solve
+        std::vector<bool> fixedVertMask; // fixedVert as a bitset over the vertices, see updateFixedVertMask()
         Eigen::Matrix<double, 2, 3> bbox;
         Eigen::VectorXd vertWeight; // for regional seam placement
         
         // indices for fast access
-        std::map<std::pair<int, int>, int> edge2Tri;
+        EdgeHashMap edge2Tri;
         std::vector<std::set<int>> vNeighbor;
-        std::map<std::pair<int, int>, int> cohEIndex;
+        EdgeHashMap cohEIndex;
         
         std::set<int> fracTail;
         int curFracTail;
         std::pair<int, int> curInteriorFracTails;
         double initSeamLen;
         
+        // the last operation applied by splitEdge(), mergeEdge() or splitOrMerge(),
+        // 0: boundary split, 1: interior split, 2: merge, -1: none
+        int lastTopoOpType = -1;
+        std::vector<int> lastTopoOpPath;
+        double lastTopoOpEwDec = 0.0;
+        
     public: // constructor
         // default constructor that doesn't do anything
         TriMesh(void);
@@ -82,7 +99,13 @@ namespace OptCuts{
     public: // API
         void computeFeatures(bool multiComp = false, bool resetFixedV = false);
         void updateFeatures(void);
+        // update indices locally after the vertex indices of the given triangles were changed
+        void updateFeatures(const std::vector<int>& triangles, const std::vector<Eigen::RowVector3i>& triVInd_old);
         void resetFixedVert(const std::set<int>& p_fixedVert);
+        // refresh fixedVertMask after fixedVert changed, done by computeFeatures() and resetFixedVert()
+        void updateFixedVertMask(void);
+        // vertices added after the last updateFixedVertMask() are free
+        bool isFixedVert(int vI) const { return (vI < fixedVertMask.size()) && fixedVertMask[vI]; }
         void buildCohEfromRecord(const Eigen::MatrixXi& cohERecord);
         
         void querySplit(double lambda_t, bool propagate, bool splitInterior,
@@ -91,7 +114,7 @@ namespace OptCuts{
         bool splitEdge(double lambda_t, double EDecThres = 0.0, bool propagate = false, bool splitInterior = false);
         void queryMerge(double lambda, bool propagate,
                         double& EwDec_max, std::vector<int>& path_max, Eigen::MatrixXd& newVertPos_max,
-                        std::pair<double, double>& energyChanges_max);
+                        std::pair<double, double>& energyChanges_max) const;
         bool mergeEdge(double lambda, double EDecThres, bool propagate);
         bool splitOrMerge(double lambda_t, double EDecThres, bool propagate, bool splitInterior,
                           bool& isMerge);
@@ -99,9 +122,14 @@ namespace OptCuts{
         void onePointCut(int vI = 0);
         void highCurvOnePointCut(void);
         void farthestPointCut(int vI = 0);
+        // one farthest point cut for each seed, which must be in different components
+        void farthestPointCut(const std::vector<int>& seeds);
         void geomImgCut(TriMesh& data_findExtrema);
         int cutPath(std::vector<int> path, bool makeCoh = false, int changePos = 0,
                      const Eigen::MatrixXd& newVertPos = Eigen::MatrixXd(), bool allowCutThrough = true);
+        // cut all interior edges of the paths at once, the paths can be closed loops, share vertices,
+        // and touch the boundary, returns the number of edges cut
+        int cutPaths(const std::vector<std::vector<int>>& paths, bool makeCoh = false);
         
         void computeSeamScore(Eigen::VectorXd& seamScore) const;
         void computeBoundaryLen(double& boundaryLen) const;
@@ -120,14 +148,36 @@ namespace OptCuts{
                   const Eigen::MatrixXd UV, const Eigen::MatrixXi& FUV = Eigen::MatrixXi()) const;
         void save(const std::string& filePath) const;
         
+        // binary snapshot of the geometry, seams and fracture tails for checkpoints,
+        // loadState() recomputes the features from it
+        void saveState(std::ostream& out) const;
+        bool loadState(std::istream& in);
+        
         void saveAsMesh(const std::string& filePath, bool scaleUV = false) const;
         
         void saveAsMesh(const std::string& filePath,
                         const Eigen::MatrixXi& F0,
                         bool scaleUV = false) const;
+        // the same mesh and UV map as saveAsMesh() with F0 in the binary container of BinaryMesh.hpp,
+        // together with the seams, the chart of each triangle and the given run metadata
+        void saveAsBinaryMesh(const std::string& filePath,
+                              const Eigen::MatrixXi& F0,
+                              const std::map<std::string, double>& meta = std::map<std::string, double>(),
+                              bool compress = false) const;
+        // the content of saveAsBinaryMesh() in memory
+        void getBinaryMesh(const Eigen::MatrixXi& F0, const std::map<std::string, double>& meta,
+                           BinaryMesh::Result& result) const;
         
     public: // helper function
+        // 3D positions of the vertices of F0, which has the triangles of F in the same order
+        void computeMeshVert(const Eigen::MatrixXi& F0, Eigen::MatrixXd& V_mesh) const;
         void computeLaplacianMtr(void);
+        const Eigen::SparseMatrix<double>& getLaplacianMtr(void);
+        // per-triangle quantities of the rest shape, and the area-weighted vertex normals
+        void computeRestShapeFeatures(std::vector<Eigen::RowVector3d>& vertNormals);
+        void computeSeamFeatures(void);
+        void computeVNeighbor(int vI, const std::set<int>& nbCandidates);
+        void computeValidSplit(int vI, const Eigen::RowVector3d& vertNormal);
         
         bool findBoundaryEdge(int vI, const std::pair<int, int>& startEdge,
                               std::pair<int, int>& boundaryEdge);
@@ -0,0 +1,659 @@
+//
+//  Checks.hpp
+//  OptCuts
+//
+
+#ifndef Checks_hpp
+#define Checks_hpp
+
+#include "IglUtils.hpp"
+#include "MeshIO.hpp"
+#include "Session.hpp"
+#include "TriMesh.hpp"
+#include "cut_to_disk.hpp"
+
+#include <igl/boundary_loop.h>
+#include <igl/facet_components.h>
+#include <igl/harmonic.h>
+#include <igl/readOBJ.h>
+#include <igl/remove_unreferenced.h>
+
+#include <sys/stat.h>  // for mkdir
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#if defined _MSC_VER
+#include <direct.h>
+
+#define mkdir(dir, mode) _mkdir(dir)
+#endif
+
+namespace OptCuts {
+    // behavior checks of the pipeline without the viewer,
+    //     OptCuts_checks checkMode [meshFilePath] [outputFolderPath]
+    // each mode prints what it compared and returns 0 if everything matched
+    class Checks
+    {
+    public:
+        static int run(int argc, char *argv[])
+        {
+            if(argc < 2) {
+                std::cout << "Please enter checkMode!" << std::endl;
+                return -1;
+            }
+
+            const int checkMode = std::stoi(argv[1]);
+            const std::string meshFilePath((argc > 2) ? argv[2] : "input/benchmark/cathead.obj");
+            std::string outputFolderPath((argc > 3) ? argv[3] : "output/checks");
+            if(outputFolderPath.back() != '/') {
+                outputFolderPath += '/';
+            }
+            mkdir(outputFolderPath.c_str(), 0777);
+
+            int failedAmt = 0;
+            switch(checkMode) {
+                case 0: {
+                    // resuming from a checkpoint of an interrupted run ends with the same result
+                    // as the run without interruption
+                    Session::Options options;
+                    options.initCutOption = 1; // the random cut would differ between the runs
+                    options.saveResultMeshes = false;
+
+                    BinaryMesh::Result result_full;
+                    {
+                        Session session;
+                        options.outputFolderPath = outputFolderPath + "checkpoint_full";
+                        options.checkpointInterval = 0.0;
+                        if(!session.load(meshFilePath) || !session.run(options)) {
+                            std::cout << "failed to run on " << meshFilePath << std::endl;
+                            return -1;
+                        }
+                        result_full = session.result();
+                    }
+
+                    // stop at the first progress report after a checkpoint was written
+                    options.outputFolderPath = outputFolderPath + "checkpoint_resumed";
+                    const std::string checkpointFilePath = options.outputFolderPath + "/checkpoint.bin";
+                    std::remove(checkpointFilePath.c_str());
+                    options.checkpointInterval = 1.0;
+                    int iterNum_stopped = -1;
+                    {
+                        Session session;
+                        Session::Callbacks callbacks;
+                        callbacks.progress = [&](const Session::Progress& progress) {
+                            iterNum_stopped = progress.iterNum;
+                            return !std::ifstream(checkpointFilePath).is_open();
+                        };
+                        session.load(meshFilePath);
+                        session.run(options, callbacks);
+                    }
+                    if(!std::ifstream(checkpointFilePath).is_open()) {
+                        std::cout << "no checkpoint was written, the run on " << meshFilePath
+                            << " is too short" << std::endl;
+                        return -1;
+                    }
+
+                    BinaryMesh::Result result_resumed;
+                    {
+                        Session session;
+                        options.resume = true;
+                        session.load(meshFilePath);
+                        session.run(options);
+                        result_resumed = session.result();
+                    }
+
+                    std::cout << "stopped at iter " << iterNum_stopped << ", full run "
+                        << result_full.meta["iterNum"] << " iters, resumed run "
+                        << result_resumed.meta["iterNum"] << " iters" << std::endl;
+                    // a run that ignored the checkpoint would also end with the same result
+                    bool resumed = false;
+                    std::ifstream logFile(options.outputFolderPath + "/log.txt");
+                    for(std::string line; std::getline(logFile, line); ) {
+                        resumed = resumed || (line.find("resumed from checkpoint") != std::string::npos);
+                    }
+                    failedAmt += !check("resumed", resumed);
+                    failedAmt += !check("V", same(result_resumed.V, result_full.V));
+                    failedAmt += !check("F", same(result_resumed.F, result_full.F));
+                    // the air mesh is rebuilt on resume instead of being restored,
+                    // which changes the UV coordinates and the energies by round-off
+                    failedAmt += !check("UV", close(result_resumed.UV, result_full.UV, 1.0e-8));
+                    failedAmt += !check("FUV", same(result_resumed.FUV, result_full.FUV));
+                    failedAmt += !check("cohE", same(result_resumed.cohE, result_full.cohE));
+                    failedAmt += !check("iterNum", result_resumed.meta["iterNum"] == result_full.meta["iterNum"]);
+                    for(const char* key : {"lambda", "distortion", "seamLen"}) {
+                        failedAmt += !check(key, std::abs(result_resumed.meta[key] - result_full.meta[key]) <=
+                                            1.0e-8 * std::abs(result_full.meta[key]));
+                    }
+                    break;
+                }
+
+                case 1: {
+                    // TriMesh::cutPaths() on a torus cut along a meridian and a longitude that share
+                    // a vertex gives the rectangle, and the cuts of cut_to_disk() give one disk per component
+                    const int m = 12, n = 8;
+                    Eigen::MatrixXd V_torus;
+                    Eigen::MatrixXi F_torus;
+                    std::vector<std::vector<int>> paths;
+                    torusGrid(m, n, V_torus, F_torus, paths);
+                    TriMesh torus(V_torus, F_torus, Eigen::MatrixXd(), Eigen::MatrixXi(), false);
+                    const int cutAmt = torus.cutPaths(paths, true);
+                    std::vector<std::vector<int>> loops;
+                    igl::boundary_loop(torus.F, loops);
+                    failedAmt += !check("torus edges cut", cutAmt == m + n);
+                    failedAmt += !check("torus vertices", torus.V_rest.rows() == (m + 1) * (n + 1));
+                    failedAmt += !check("torus boundary", (loops.size() == 1) && (loops[0].size() == 2 * (m + n)));
+                    failedAmt += !check("torus euler characteristic", IglUtils::eulerCharacteristic(torus.F) == 1);
+                    failedAmt += !check("torus corners", sameCorners(torus, V_torus, F_torus));
+                    failedAmt += !check("torus seams", (torus.cohE.rows() == m + n) && splitSeams(torus));
+
+                    Eigen::MatrixXd V, TC, N;
+                    Eigen::MatrixXi F, FTC, FN;
+                    if(!MeshIO::readOBJ(meshFilePath, V, TC, N, F, FTC, FN)) {
+                        return -1;
+                    }
+                    std::vector<std::vector<int>> cuts;
+                    igl::cut_to_disk(F, cuts);
+                    TriMesh mesh(V, F, Eigen::MatrixXd(), Eigen::MatrixXi(), false);
+                    mesh.cutPaths(cuts, true);
+                    Eigen::VectorXi C;
+                    igl::facet_components(mesh.F, C);
+                    std::vector<Eigen::MatrixXi> F_component(C.maxCoeff() + 1);
+                    IglUtils::splitFaceComponents(mesh.F, C, F_component);
+                    // closed genus-0 components get no cuts, they are left to the point cuts
+                    int diskAmt = 0, sphereAmt = 0;
+                    for(const auto& F_componentI : F_component) {
+                        loops.clear(); // boundary_loop() appends
+                        igl::boundary_loop(F_componentI, loops);
+                        const int eulerChar = IglUtils::eulerCharacteristic(F_componentI);
+                        diskAmt += ((eulerChar == 1) && (loops.size() == 1));
+                        sphereAmt += ((eulerChar == 2) && loops.empty());
+                    }
+                    std::cout << meshFilePath << ": " << cuts.size() << " cuts, " << F_component.size()
+                        << " components, " << diskAmt << " disks, " << sphereAmt << " spheres" << std::endl;
+                    failedAmt += !check("mesh components are disks", diskAmt + sphereAmt == F_component.size());
+                    failedAmt += !check("mesh corners", sameCorners(mesh, V, F));
+                    failedAmt += !check("mesh seams", splitSeams(mesh));
+                    break;
+                }
+
+                case 2: {
+                    // IglUtils::harmonicParam_multiComp() on the mesh cut to disks fixes the longest boundary loop
+                    // of each component on a unit circle, matches igl::harmonic() with uniform weights inside,
+                    // has no flipped triangles, and packs the components without overlaps
+                    Eigen::MatrixXd V, TC, N;
+                    Eigen::MatrixXi F, FTC, FN;
+                    if(!MeshIO::readOBJ(meshFilePath, V, TC, N, F, FTC, FN)) {
+                        return -1;
+                    }
+                    std::vector<std::vector<int>> cuts;
+                    igl::cut_to_disk(F, cuts);
+                    TriMesh mesh(V, F, Eigen::MatrixXd(), Eigen::MatrixXi(), false);
+                    mesh.cutPaths(cuts, true);
+                    Eigen::VectorXi C;
+                    igl::facet_components(mesh.F, C);
+                    std::vector<Eigen::MatrixXi> F_component(C.maxCoeff() + 1);
+                    IglUtils::splitFaceComponents(mesh.F, C, F_component);
+                    for(const auto& F_componentI : F_component) {
+                        if(IglUtils::eulerCharacteristic(F_componentI) == 2) {
+                            mesh.onePointCut(F_componentI(0, 0));
+                        }
+                    }
+                    igl::facet_components(mesh.F, C);
+                    F_component.resize(C.maxCoeff() + 1);
+                    IglUtils::splitFaceComponents(mesh.F, C, F_component);
+
+                    Eigen::MatrixXd UV;
+                    IglUtils::harmonicParam_multiComp(mesh.V_rest, F_component, UV);
+
+                    double maxRadiusErr = 0.0, maxInteriorErr = 0.0, uvScale = 0.0;
+                    int flippedAmt = 0, overlapAmt = 0, outsideAmt = 0;
+                    std::vector<Eigen::RowVector2d> bboxMin, bboxMax;
+                    for(const auto& F_componentI : F_component) {
+                        Eigen::MatrixXd UV_local;
+                        Eigen::MatrixXi F_local;
+                        Eigen::VectorXi I, J;
+                        igl::remove_unreferenced(UV, F_componentI, UV_local, F_local, I, J);
+                        bboxMin.emplace_back(UV_local.colwise().minCoeff());
+                        bboxMax.emplace_back(UV_local.colwise().maxCoeff());
+                        uvScale = std::max(uvScale, UV_local.cwiseAbs().maxCoeff());
+
+                        std::vector<std::vector<int>> loops;
+                        igl::boundary_loop(F_local, loops);
+                        int longestI = 0;
+                        for(int loopI = 1; loopI < loops.size(); loopI++) {
+                            if(loops[loopI].size() > loops[longestI].size()) {
+                                longestI = loopI;
+                            }
+                        }
+                        const Eigen::VectorXi bnd = Eigen::VectorXi::Map(loops[longestI].data(), loops[longestI].size());
+                        Eigen::MatrixXd bnd_uv(bnd.size(), 2);
+                        for(int bndI = 0; bndI < bnd.size(); bndI++) {
+                            bnd_uv.row(bndI) = UV_local.row(bnd[bndI]);
+                        }
+                        const Eigen::RowVector2d center = circumcenter(bnd_uv.row(0), bnd_uv.row(bnd.size() / 3),
+                                                                       bnd_uv.row(2 * bnd.size() / 3));
+                        for(int bndI = 0; bndI < bnd.size(); bndI++) {
+                            maxRadiusErr = std::max(maxRadiusErr, std::abs((bnd_uv.row(bndI) - center).norm() - 1.0));
+                        }
+                        // the rest of the component inside the circle
+                        outsideAmt += ((bboxMax.back() - bboxMin.back()).maxCoeff() > 2.0 + 1.0e-8);
+
+                        // the same boundary for the reference so that only the interior is compared
+                        if(bnd.size() < UV_local.rows()) {
+                            Eigen::MatrixXd UV_ref;
+                            if(!igl::harmonic(F_local, bnd, bnd_uv, 1, UV_ref)) {
+                                std::cout << "igl::harmonic failed" << std::endl;
+                                return -1;
+                            }
+                            maxInteriorErr = std::max(maxInteriorErr, (UV_ref - UV_local).cwiseAbs().maxCoeff());
+                        }
+
+                        int positiveAmt = 0;
+                        for(int triI = 0; triI < F_local.rows(); triI++) {
+                            const Eigen::RowVector2d e0 = UV_local.row(F_local(triI, 1)) - UV_local.row(F_local(triI, 0));
+                            const Eigen::RowVector2d e1 = UV_local.row(F_local(triI, 2)) - UV_local.row(F_local(triI, 0));
+                            positiveAmt += (e0[0] * e1[1] - e0[1] * e1[0] > 0.0);
+                        }
+                        flippedAmt += std::min(positiveAmt, static_cast<int>(F_local.rows()) - positiveAmt);
+                    }
+                    for(int compI = 0; compI < bboxMin.size(); compI++) {
+                        for(int compJ = compI + 1; compJ < bboxMin.size(); compJ++) {
+                            overlapAmt += ((bboxMin[compI].array() < bboxMax[compJ].array()).all() &&
+                                           (bboxMin[compJ].array() < bboxMax[compI].array()).all());
+                        }
+                    }
+
+                    std::cout << meshFilePath << ": " << F_component.size() << " components, boundary radius error "
+                        << maxRadiusErr << ", interior difference to igl::harmonic " << maxInteriorErr << std::endl;
+                    failedAmt += !check("boundary on unit circles", (maxRadiusErr < 1.0e-8) && !outsideAmt);
+                    failedAmt += !check("interior harmonic", maxInteriorErr <= 1.0e-8 * uvScale);
+                    failedAmt += !check("no flipped triangles", !flippedAmt);
+                    failedAmt += !check("no overlapping components", !overlapAmt);
+                    break;
+                }
+
+                case 3: {
+                    // MeshIO::readOBJ() loads the same mesh as igl::readOBJ() with the polygons triangulated as fans,
+                    // on the given file and on small files with all face formats, negative indices and polygons,
+                    // and rejects faces with indices out of range or too long for an int
+                    const int n = 6;
+                    std::vector<std::string> faceFormats = {"v", "v/vt", "v/vt/vn", "v//vn", "-v", "-v/-vt/-vn", "quad", "interleaved"};
+                    std::vector<std::string> filePaths(1, meshFilePath), labels(1, meshFilePath);
+                    for(const auto& format : faceFormats) {
+                        filePaths.emplace_back(outputFolderPath + "obj_" + std::to_string(filePaths.size()) + ".obj");
+                        labels.emplace_back("f " + format);
+                        std::ofstream file(filePaths.back());
+                        file << std::setprecision(17);
+                        auto writeVert = [&file, n](int i, int j) {
+                            file << "v " << 0.1 * i << " " << 0.1 * j + 1.0e-3 * std::sin(i * j) << " " << std::cos(i + j) / 3.0 << "\n";
+                            file << "vt " << i / (n - 1.0) << " " << j / (n - 1.0) << "\n";
+                            file << "vn 0 " << std::sin(i) << " " << std::cos(i) << "\n";
+                        };
+                        if(format == "interleaved") {
+                            // negative indices relative to the elements before each face
+                            for(int i = 0; i + 1 < n; i++) {
+                                for(int j = 0; j + 1 < n; j++) {
+                                    writeVert(i, j);
+                                    writeVert(i + 1, j);
+                                    writeVert(i + 1, j + 1);
+                                    file << "f -3/-3/-3 -2/-2/-2 -1/-1/-1\n";
+                                }
+                            }
+                            continue;
+                        }
+                        for(int i = 0; i < n; i++) {
+                            for(int j = 0; j < n; j++) {
+                                writeVert(i, j);
+                            }
+                        }
+                        for(int i = 0; i + 1 < n; i++) {
+                            for(int j = 0; j + 1 < n; j++) {
+                                const int a = i * n + j, b = a + n, c = b + 1, d = a + 1;
+                                std::vector<std::vector<int>> polys = {{a, b, c}, {a, c, d}};
+                                if(format == "quad") {
+                                    polys = {{a, b, c, d}};
+                                }
+                                for(const auto& poly : polys) {
+                                    file << "f";
+                                    for(const auto& vI : poly) {
+                                        const int ind = ((format[0] == '-') ? (vI - n * n) : (vI + 1));
+                                        file << " " << ind;
+                                        if(format.find("vt") != std::string::npos) {
+                                            file << "/" << ind;
+                                        }
+                                        else if(format.find("vn") != std::string::npos) {
+                                            file << "/";
+                                        }
+                                        if(format.find("vn") != std::string::npos) {
+                                            file << "/" << ind;
+                                        }
+                                    }
+                                    file << "\n";
+                                }
+                            }
+                        }
+                    }
+                    for(int fileI = 0; fileI < filePaths.size(); fileI++) {
+                        failedAmt += !check(labels[fileI], sameAsIglOBJ(filePaths[fileI]));
+                    }
+
+                    const std::vector<std::string> invalidFaces = {
+                        "f 1 2 4", "f 1 2 -4", "f 1 2 0", "f 1 2 99999999999999999999",
+                        "f 1 2 -9223372036854775809", "f 1/1 2/1 3/18446744073709551617", "f 1/1 2/1 3/2", "f 1 2"
+                    };
+                    for(const auto& face : invalidFaces) {
+                        const std::string filePath = outputFolderPath + "obj_invalid.obj";
+                        std::ofstream(filePath) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\n" << face << "\n";
+                        Eigen::MatrixXd V;
+                        Eigen::MatrixXi F;
+                        failedAmt += !check("rejects " + face, !MeshIO::readOBJ(filePath, V, F));
+                    }
+                    break;
+                }
+
+                case 4: {
+                    // a BinaryMesh::Result of the given mesh and of extreme values reads back bit for bit
+                    // from .ocmesh files, raw and compressed, truncated files are rejected,
+                    // and selections read back as written
+                    BinaryMesh::Result result;
+                    Eigen::MatrixXd TC, N;
+                    Eigen::MatrixXi FTC, FN;
+                    if(!MeshIO::readOBJ(meshFilePath, result.V, TC, N, result.F, FTC, FN)) {
+                        return -1;
+                    }
+                    const double extremes[] = {
+                        -0.0, std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max(),
+                        -std::numeric_limits<double>::infinity(), 0.1, -1.0 / 3.0
+                    };
+                    result.UV.resize(result.V.rows() + 6, 2);
+                    for(int vI = 0; vI < result.UV.rows(); vI++) {
+                        result.UV.row(vI) << ((vI < 6) ? extremes[vI] : std::sin(vI)), std::cos(vI) * 1.0e-3;
+                    }
+                    result.FUV = result.F.array() + 6;
+                    result.cohE.resize(result.F.rows(), 4);
+                    result.chartId.resize(result.F.rows());
+                    for(int triI = 0; triI < result.F.rows(); triI++) {
+                        result.cohE.row(triI) << result.F(triI, 0), result.F(triI, 1),
+                            ((triI % 3) ? -1 : result.F(triI, 2)), std::numeric_limits<int>::min() + triI;
+                        result.chartId[triI] = triI % 7;
+                    }
+                    result.meta["lambda"] = 0.1;
+                    result.meta["distortion"] = 4.0 + 1.0 / 3.0;
+                    result.meta["iterNum"] = 123456789.0;
+
+                    BinaryMesh::Result result_VF;
+                    result_VF.V = result.V;
+                    result_VF.F = result.F;
+                    for(int compress = 0; compress < 1 + BinaryMesh::compressionAvailable(); compress++) {
+                        for(const auto* resultI : {&result, &result_VF}) {
+                            const std::string filePath = outputFolderPath + "roundTrip.ocmesh";
+                            const std::string label = std::string(compress ? "compressed " : "raw ") +
+                                ((resultI == &result) ? "all sections" : "V and F");
+                            BinaryMesh::Result result_read;
+                            if(!BinaryMesh::write(filePath, *resultI, compress) || !BinaryMesh::read(filePath, result_read)) {
+                                failedAmt += !check(label, false);
+                                continue;
+                            }
+                            failedAmt += !check(label, sameBits(result_read.V, resultI->V) && same(result_read.F, resultI->F) &&
+                                                sameBits(result_read.UV, resultI->UV) && same(result_read.FUV, resultI->FUV) &&
+                                                same(result_read.cohE, resultI->cohE) && same(result_read.chartId, resultI->chartId) &&
+                                                (result_read.meta == resultI->meta));
+
+                            // in place use of the mapping
+                            BinaryMesh::Reader reader(filePath);
+                            bool aligned = reader.isValid();
+                            for(const auto& section : reader.getSections()) {
+                                aligned = aligned && !(section.offset % BinaryMesh::alignment) &&
+                                    (compress || reader.rawData(section));
+                            }
+                            failedAmt += !check(label + ": aligned", aligned);
+
+                            // truncations inside the header, the section table and the data
+                            std::ifstream file(filePath, std::ios::binary);
+                            const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                            const std::string truncatedFilePath = outputFolderPath + "roundTrip_truncated.ocmesh";
+                            bool rejected = true;
+                            for(size_t size : {size_t(0), size_t(32), size_t(100), content.size() / 2, content.size() - 1}) {
+                                std::ofstream(truncatedFilePath, std::ios::binary).write(content.data(), size);
+                                rejected = rejected && !BinaryMesh::read(truncatedFilePath, result_read);
+                            }
+                            failedAmt += !check(label + ": truncations rejected", rejected);
+                        }
+                    }
+
+                    std::vector<char> selected(1001), selected_read;
+                    for(int vI = 0; vI < selected.size(); vI++) {
+                        selected[vI] = ((vI % 3 == 0) || (vI == 1000));
+                    }
+                    const std::string selectionFilePath = outputFolderPath + "selection.ocmesh";
+                    failedAmt += !check("selection", BinaryMesh::writeSelection(selectionFilePath, selected) &&
+                                        BinaryMesh::readSelection(selectionFilePath, 1001, selected_read) &&
+                                        (selected_read == selected));
+                    failedAmt += !check("selection of fewer vertices",
+                                        BinaryMesh::readSelection(selectionFilePath, 500, selected_read) &&
+                                        std::equal(selected_read.begin(), selected_read.end(), selected.begin()) &&
+                                        (selected_read.size() == 500));
+                    break;
+                }
+
+                case 5: {
+                    // TriMesh::saveAsMesh() welds the triangle soup of the given mesh and a torus cut to a disk
+                    // back into the input meshes, up to the order of the vertices
+                    Eigen::MatrixXd V, TC, N;
+                    Eigen::MatrixXi F, FTC, FN;
+                    if(!MeshIO::readOBJ(meshFilePath, V, TC, N, F, FTC, FN)) {
+                        return -1;
+                    }
+                    const TriMesh soup(V, F, V.leftCols(2), F, true);
+                    failedAmt += !check("triangle soup of " + meshFilePath,
+                                        weldsBack(soup, V, F, outputFolderPath + "weld_soup.obj"));
+
+                    Eigen::MatrixXd V_torus;
+                    Eigen::MatrixXi F_torus;
+                    std::vector<std::vector<int>> paths;
+                    torusGrid(12, 8, V_torus, F_torus, paths);
+                    TriMesh torus(V_torus, F_torus, Eigen::MatrixXd(), Eigen::MatrixXi(), false);
+                    torus.cutPaths(paths, true);
+                    failedAmt += !check("torus cut to a disk", weldsBack(torus, V_torus, F_torus,
+                                                                         outputFolderPath + "weld_torus.obj"));
+                    break;
+                }
+
+                default:
+                    std::cout << "No checkMode " << checkMode << std::endl;
+                    return -1;
+            }
+
+            std::cout << (failedAmt ? "FAILED" : "passed") << std::endl;
+            return failedAmt;
+        }
+
+    protected:
+        static bool check(const std::string& name, bool passed)
+        {
+            std::cout << (passed ? "  ok    " : "  FAIL  ") << name << std::endl;
+            return passed;
+        }
+
+        // each triangle corner is still at the position of its vertex in the uncut mesh
+        static bool sameCorners(const TriMesh& mesh, const Eigen::MatrixXd& V0, const Eigen::MatrixXi& F0)
+        {
+            if(mesh.F.rows() != F0.rows()) {
+                return false;
+            }
+            for(int triI = 0; triI < F0.rows(); triI++) {
+                for(int i = 0; i < 3; i++) {
+                    if(mesh.V_rest.row(mesh.F(triI, i)) != V0.row(F0(triI, i))) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // the two sides of each seam are at the same positions but on different vertices
+        static bool splitSeams(const TriMesh& mesh)
+        {
+            for(int cohI = 0; cohI < mesh.cohE.rows(); cohI++) {
+                for(int i = 0; i < 2; i++) {
+                    const int vI = mesh.cohE(cohI, i), vI_opp = mesh.cohE(cohI, i + 2);
+                    if((vI == vI_opp) || (mesh.V_rest.row(vI) != mesh.V_rest.row(vI_opp))) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // the polygons of igl::readOBJ() triangulated as fans, FTC and FN only if every face has them
+        static bool sameAsIglOBJ(const std::string& filePath)
+        {
+            Eigen::MatrixXd V, TC, N;
+            Eigen::MatrixXi F, FTC, FN;
+            std::vector<std::vector<double>> V_igl, TC_igl, N_igl;
+            std::vector<std::vector<int>> F_igl, FTC_igl, FN_igl;
+            if(!MeshIO::readOBJ(filePath, V, TC, N, F, FTC, FN) ||
+               !igl::readOBJ(filePath, V_igl, TC_igl, N_igl, F_igl, FTC_igl, FN_igl))
+            {
+                return false;
+            }
+
+            auto sameRows = [](const Eigen::MatrixXd& mtr, const std::vector<std::vector<double>>& rows) {
+                if(mtr.rows() != rows.size()) {
+                    return false;
+                }
+                for(int rowI = 0; rowI < rows.size(); rowI++) {
+                    for(int colI = 0; colI < mtr.cols(); colI++) {
+                        // a missing second texture coordinate is 0
+                        if(mtr(rowI, colI) != ((colI < rows[rowI].size()) ? rows[rowI][colI] : 0.0)) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            };
+            bool allTC = (FTC_igl.size() == F_igl.size()), allN = (FN_igl.size() == F_igl.size());
+            for(int polyI = 0; polyI < F_igl.size(); polyI++) {
+                allTC = allTC && (FTC_igl[polyI].size() == F_igl[polyI].size());
+                allN = allN && (FN_igl[polyI].size() == F_igl[polyI].size());
+            }
+            auto sameFans = [&F_igl](const Eigen::MatrixXi& tris, const std::vector<std::vector<int>>& polys) {
+                int triI = 0;
+                for(int polyI = 0; polyI < F_igl.size(); polyI++) {
+                    for(int cornerI = 1; cornerI + 1 < F_igl[polyI].size(); cornerI++, triI++) {
+                        if((triI >= tris.rows()) || (tris(triI, 0) != polys[polyI][0]) ||
+                           (tris(triI, 1) != polys[polyI][cornerI]) || (tris(triI, 2) != polys[polyI][cornerI + 1]))
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return (triI == tris.rows());
+            };
+
+            return sameRows(V, V_igl) && sameRows(TC, TC_igl) && sameRows(N, N_igl) && sameFans(F, F_igl) &&
+                (allTC ? sameFans(FTC, FTC_igl) : !FTC.rows()) && (allN ? sameFans(FN, FN_igl) : !FN.rows());
+        }
+
+        // m x n vertices, paths are a closed meridian and a closed longitude through vertex 0
+        static void torusGrid(int m, int n, Eigen::MatrixXd& V, Eigen::MatrixXi& F, std::vector<std::vector<int>>& paths)
+        {
+            V.resize(m * n, 3);
+            F.resize(m * n * 2, 3);
+            for(int i = 0; i < m; i++) {
+                for(int j = 0; j < n; j++) {
+                    const double theta = 2.0 * M_PI * i / m, phi = 2.0 * M_PI * j / n;
+                    V.row(i * n + j) << (2.0 + std::cos(phi)) * std::cos(theta),
+                        (2.0 + std::cos(phi)) * std::sin(theta), std::sin(phi);
+                    const int a = i * n + j, b = ((i + 1) % m) * n + j;
+                    const int c = i * n + (j + 1) % n, d = ((i + 1) % m) * n + (j + 1) % n;
+                    F.row((i * n + j) * 2) << a, b, d;
+                    F.row((i * n + j) * 2 + 1) << a, d, c;
+                }
+            }
+            paths.assign(2, std::vector<int>());
+            for(int j = 0; j <= n; j++) {
+                paths[0].emplace_back(j % n);
+            }
+            for(int i = 0; i <= m; i++) {
+                paths[1].emplace_back((i % m) * n);
+            }
+        }
+
+        // the OBJ written by saveAsMesh() has a vertex for each vertex of F0 at its position (with the 6 digits
+        // of the file), and the triangles of F0 in these vertices
+        static bool weldsBack(const TriMesh& mesh, const Eigen::MatrixXd& V0, const Eigen::MatrixXi& F0,
+                              const std::string& filePath)
+        {
+            mesh.saveAsMesh(filePath);
+            Eigen::MatrixXd V;
+            Eigen::MatrixXi F;
+            if(!MeshIO::readOBJ(filePath, V, F) || (F.rows() != F0.rows())) {
+                return false;
+            }
+            std::vector<int> toV0(V.rows(), -1), fromV0(V0.rows(), -1);
+            for(int triI = 0; triI < F.rows(); triI++) {
+                for(int i = 0; i < 3; i++) {
+                    const int vI = F(triI, i), vI0 = F0(triI, i);
+                    if(((toV0[vI] >= 0) && (toV0[vI] != vI0)) || ((fromV0[vI0] >= 0) && (fromV0[vI0] != vI))) {
+                        return false;
+                    }
+                    toV0[vI] = vI0;
+                    fromV0[vI0] = vI;
+                }
+            }
+            const double tol = 1.0e-5 * V0.cwiseAbs().maxCoeff();
+            for(int vI = 0; vI < V.rows(); vI++) {
+                if((toV0[vI] < 0) || ((V.row(vI) - V0.row(toV0[vI])).cwiseAbs().maxCoeff() > tol)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // also tells -0.0 from 0.0
+        static bool sameBits(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b)
+        {
+            return (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+                !memcmp(a.data(), b.data(), a.size() * sizeof(double));
+        }
+
+        static Eigen::RowVector2d circumcenter(const Eigen::RowVector2d& a, const Eigen::RowVector2d& b,
+                                               const Eigen::RowVector2d& c)
+        {
+            const Eigen::RowVector2d ab = b - a, ac = c - a;
+            const double d = 2.0 * (ab[0] * ac[1] - ab[1] * ac[0]);
+            return a + Eigen::RowVector2d(ac[1] * ab.squaredNorm() - ab[1] * ac.squaredNorm(),
+                                          ab[0] * ac.squaredNorm() - ac[0] * ab.squaredNorm()) / d;
+        }
+
+        template<typename DerivedA, typename DerivedB>
+        static bool same(const Eigen::MatrixBase<DerivedA>& a, const Eigen::MatrixBase<DerivedB>& b)
+        {
+            return (a.rows() == b.rows()) && (a.cols() == b.cols()) && (a == b);
+        }
+
+        // the largest difference relative to the largest magnitude in b
+        static bool close(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b, double relTol)
+        {
+            if((a.rows() != b.rows()) || (a.cols() != b.cols())) {
+                return false;
+            }
+            if(!b.size()) {
+                return true;
+            }
+            const double maxDiff = (a - b).cwiseAbs().maxCoeff();
+            std::cout << "  max difference " << maxDiff << std::endl;
+            return maxDiff <= relTol * b.cwiseAbs().maxCoeff();
+        }
+    };
+}
+
+#endif /* Checks_hpp */
@@ -8,8 +8,6 @@
 #ifndef MeshProcessing_hpp
 #define MeshProcessing_hpp
 
-#include <igl/readOFF.h>
-#include <igl/readOBJ.h>
 #include <igl/writeOBJ.h>
 #include <igl/boundary_loop.h>
 #include <igl/map_vertices_to_circle.h>
@@ -19,6 +17,8 @@
 
 #include <cstdio>
 
+#include "MeshIO.hpp"
+
 extern std::string outputFolderPath;
 
 namespace OptCuts {
@@ -35,10 +35,10 @@ namespace OptCuts {
                 std::string meshName = meshFileName.substr(0, meshFileName.find_last_of('.'));
                 const std::string suffix = meshFileName.substr(meshFileName.find_last_of('.'));
                 if(suffix == ".off") {
-                    igl::readOFF(meshPath, V, F);
+                    MeshIO::readOFF(meshPath, V, F);
                 }
                 else if(suffix == ".obj") {
-                    igl::readOBJ(meshPath, V, UV, N, F, FUV, FN);
+                    MeshIO::readOBJ(meshPath, V, UV, N, F, FUV, FN);
                 }
                 else {
                     std::cout << "unkown mesh file format!" << std::endl;
@@ -79,10 +79,10 @@ namespace OptCuts {
                                 std::string meshPath = std::string(argv[4]);
                                 const std::string suffix = meshPath.substr(meshPath.find_last_of('.'));
                                 if(suffix == ".off") {
-                                    igl::readOFF(meshPath, V0, F0);
+                                    MeshIO::readOFF(meshPath, V0, F0);
                                 }
                                 else if(suffix == ".obj") {
-                                    igl::readOBJ(meshPath, V0, F0);
+                                    MeshIO::readOBJ(meshPath, V0, F0);
                                 }
                                 else {
                                     std::cout << "unkown mesh file format!" << std::endl;
@@ -257,7 +257,7 @@ namespace OptCuts {
                             // merge closed surface mesh file and UV file
                             Eigen::MatrixXd V_UV;
                             Eigen::MatrixXi F_UV;
-                            igl::readOBJ(meshPath.substr(0, meshPath.find("_closed.obj")) + ".obj",
+                            MeshIO::readOBJ(meshPath.substr(0, meshPath.find("_closed.obj")) + ".obj",
                                                          V_UV, F_UV);
                             Eigen::VectorXi bnd;
                             igl::boundary_loop(F_UV, bnd); // Find the open boundary
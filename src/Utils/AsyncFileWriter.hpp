@@ -0,0 +1,258 @@
+//
+//  AsyncFileWriter.hpp
+//  OptCuts
+//
+
+#ifndef AsyncFileWriter_hpp
+#define AsyncFileWriter_hpp
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace OptCuts {
+
+    // appends to a file from a background thread so that the callers only copy
+    // into a memory buffer, the buffer is handed to the writer thread once it
+    // reaches flushSize bytes or every flushInterval, and on close()
+    class AsyncFileWriter {
+    protected:
+        std::ofstream file;
+        std::thread writerThread;
+        std::atomic<bool> opened;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::string pending; // written by the callers, swapped out by the writer thread
+        bool closing;
+        size_t flushSize;
+        std::chrono::milliseconds flushInterval;
+
+    public:
+        AsyncFileWriter(size_t p_flushSize = 64 * 1024, int p_flushInterval_ms = 500) :
+            opened(false), closing(false), flushSize(p_flushSize), flushInterval(p_flushInterval_ms) {}
+        ~AsyncFileWriter(void) { close(); }
+
+        AsyncFileWriter(const AsyncFileWriter&) = delete;
+        AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+        bool open(const std::string& filePath, bool binary = false, bool append = false) {
+            close();
+            file.open(filePath, (binary ? (std::ios::out | std::ios::binary) : std::ios::out) |
+                      (append ? std::ios::app : std::ios::out));
+            if(!file.is_open()) {
+                return false;
+            }
+            closing = false;
+            opened.store(true, std::memory_order_release);
+            writerThread = std::thread(&AsyncFileWriter::run, this);
+            return true;
+        }
+
+        bool isOpen(void) const { return opened.load(std::memory_order_acquire); }
+
+        void write(const std::string& str) { write(str.data(), str.size()); }
+        void write(const char* data, size_t size) {
+            if(!isOpen()) {
+                return;
+            }
+            bool notify;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.append(data, size);
+                notify = (pending.size() >= flushSize);
+            }
+            if(notify) {
+                cond.notify_one();
+            }
+        }
+
+        // writes everything pending and closes the file, blocks until done
+        void close(void) {
+            if(!isOpen()) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closing = true;
+            }
+            cond.notify_one();
+            writerThread.join();
+            file.close();
+            opened.store(false, std::memory_order_release);
+        }
+
+    protected:
+        void run(void) {
+            std::string writing;
+            while(true) {
+                bool done;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait_for(lock, flushInterval, [this] { return closing || (pending.size() >= flushSize); });
+                    writing.swap(pending);
+                    done = closing;
+                }
+                if(!writing.empty()) {
+                    file.write(writing.data(), writing.size());
+                    file.flush();
+                    writing.clear();
+                }
+                if(done) {
+                    break;
+                }
+            }
+        }
+    };
+
+    // replaces a file with new content from a background thread,
+    // the content goes to filePath.tmp first and is then renamed over filePath
+    // so that an interrupted save never leaves a partial file behind,
+    // a save waits for the previous one to finish,
+    // failures are kept for takeError() as the saver thread cannot report them safely
+    class AsyncFileSaver {
+    protected:
+        std::thread saverThread;
+        std::string error; // of the last save, empty if it succeeded, written by the saver thread
+
+    public:
+        AsyncFileSaver(void) {}
+        ~AsyncFileSaver(void) { wait(); }
+
+        AsyncFileSaver(const AsyncFileSaver&) = delete;
+        AsyncFileSaver& operator=(const AsyncFileSaver&) = delete;
+
+        void save(const std::string& filePath, std::string content) {
+            wait();
+            saverThread = std::thread([this, filePath](const std::string& p_content) {
+                error = saveNow(filePath, p_content);
+            }, std::move(content));
+        }
+
+        void wait(void) {
+            if(saverThread.joinable()) {
+                saverThread.join();
+            }
+        }
+
+        // waits for the last save, returns whether it failed with the reason in message,
+        // each failure is returned once
+        bool takeError(std::string& message) {
+            wait();
+            if(error.empty()) {
+                return false;
+            }
+            message.swap(error);
+            error.clear();
+            return true;
+        }
+
+    protected:
+        // returns the reason of a failure, empty on success
+        static std::string saveNow(const std::string& filePath, const std::string& content) {
+            const std::string tmpFilePath = filePath + ".tmp";
+            std::ofstream file(tmpFilePath, std::ios::out | std::ios::binary);
+            if(!file.is_open()) {
+                return "cannot open " + tmpFilePath + ": " + std::strerror(errno);
+            }
+            file.write(content.data(), content.size());
+            file.close();
+            if(!file) {
+                std::remove(tmpFilePath.c_str());
+                return "cannot write " + tmpFilePath;
+            }
+            if(std::rename(tmpFilePath.c_str(), filePath.c_str()) != 0) {
+                return "cannot rename " + tmpFilePath + " to " + filePath + ": " + std::strerror(errno);
+            }
+            return std::string();
+        }
+    };
+
+    // runs output jobs such as mesh saves on a background thread in the order they were posted,
+    // each job owns the snapshot it writes, post() blocks while maxPending jobs are queued
+    // so that snapshots cannot pile up when the disk is slower than the computation
+    class AsyncOutputQueue {
+    protected:
+        std::thread workerThread;
+        std::mutex mutex;
+        std::condition_variable condJob; // for the worker: a job was posted or stop() was called
+        std::condition_variable condDone; // for the callers: a job was taken or finished
+        std::deque<std::function<void(void)>> jobs;
+        size_t maxPending;
+        bool running; // the worker is running a job
+        bool stopping;
+
+    public:
+        AsyncOutputQueue(size_t p_maxPending = 4) :
+            maxPending(p_maxPending), running(false), stopping(false) {}
+        ~AsyncOutputQueue(void) { stop(); }
+
+        AsyncOutputQueue(const AsyncOutputQueue&) = delete;
+        AsyncOutputQueue& operator=(const AsyncOutputQueue&) = delete;
+
+        void post(std::function<void(void)> job) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if(!workerThread.joinable()) {
+                    stopping = false;
+                    workerThread = std::thread(&AsyncOutputQueue::run, this);
+                }
+                condDone.wait(lock, [this] { return jobs.size() < maxPending; });
+                jobs.emplace_back(std::move(job));
+            }
+            condJob.notify_one();
+        }
+
+        // blocks until all posted jobs are done
+        void wait(void) {
+            std::unique_lock<std::mutex> lock(mutex);
+            condDone.wait(lock, [this] { return jobs.empty() && !running; });
+        }
+
+        // runs the remaining jobs and ends the worker, blocks until done
+        void stop(void) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!workerThread.joinable()) {
+                    return;
+                }
+                stopping = true;
+            }
+            condJob.notify_one();
+            workerThread.join();
+        }
+
+    protected:
+        void run(void) {
+            std::unique_lock<std::mutex> lock(mutex);
+            while(true) {
+                condJob.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if(jobs.empty()) {
+                    break;
+                }
+                std::function<void(void)> job = std::move(jobs.front());
+                jobs.pop_front();
+                running = true;
+                lock.unlock();
+                condDone.notify_all();
+
+                job();
+
+                lock.lock();
+                running = false;
+                condDone.notify_all();
+            }
+        }
+    };
+
+}
+
+#endif /* AsyncFileWriter_hpp */
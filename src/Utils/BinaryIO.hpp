@@ -0,0 +1,105 @@
+//
+//  BinaryIO.hpp
+//  OptCuts
+//
+
+#ifndef BinaryIO_hpp
+#define BinaryIO_hpp
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace OptCuts {
+
+    // raw native-endian serialization of the types kept in the optimization state,
+    // readers return false on a truncated or inconsistent stream
+    namespace BinaryIO {
+
+        template<typename T>
+        void write(std::ostream& out, const T& val) {
+            static_assert(std::is_arithmetic<T>::value, "only arithmetic types are written raw");
+            out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+        }
+        template<typename T>
+        bool read(std::istream& in, T& val) {
+            static_assert(std::is_arithmetic<T>::value, "only arithmetic types are read raw");
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&val), sizeof(T)));
+        }
+
+        template<typename Derived>
+        void writeMatrix(std::ostream& out, const Eigen::PlainObjectBase<Derived>& mtr) {
+            typedef typename Derived::Scalar Scalar;
+            write<int64_t>(out, mtr.rows());
+            write<int64_t>(out, mtr.cols());
+            // Eigen storage is column-major by default, which is also what is read back
+            const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> colMajor = mtr;
+            out.write(reinterpret_cast<const char*>(colMajor.data()), sizeof(Scalar) * colMajor.size());
+        }
+        template<typename Derived>
+        bool readMatrix(std::istream& in, Eigen::PlainObjectBase<Derived>& mtr) {
+            typedef typename Derived::Scalar Scalar;
+            int64_t rows, cols;
+            if(!read(in, rows) || !read(in, cols) || (rows < 0) || (cols < 0)) {
+                return false;
+            }
+            if(((Derived::RowsAtCompileTime != Eigen::Dynamic) && (rows != Derived::RowsAtCompileTime)) ||
+               ((Derived::ColsAtCompileTime != Eigen::Dynamic) && (cols != Derived::ColsAtCompileTime)))
+            {
+                return false;
+            }
+            Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> colMajor(rows, cols);
+            if(!in.read(reinterpret_cast<char*>(colMajor.data()), sizeof(Scalar) * colMajor.size())) {
+                return false;
+            }
+            mtr = colMajor;
+            return true;
+        }
+
+        template<typename T>
+        void writeVector(std::ostream& out, const std::vector<T>& vec) {
+            write<int64_t>(out, vec.size());
+            for(const auto& valI : vec) {
+                write(out, valI);
+            }
+        }
+        template<typename T>
+        bool readVector(std::istream& in, std::vector<T>& vec) {
+            int64_t size;
+            if(!read(in, size) || (size < 0)) {
+                return false;
+            }
+            vec.resize(size);
+            for(auto& valI : vec) {
+                if(!read(in, valI)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template<typename T>
+        void writeSet(std::ostream& out, const std::set<T>& set) {
+            writeVector(out, std::vector<T>(set.begin(), set.end()));
+        }
+        template<typename T>
+        bool readSet(std::istream& in, std::set<T>& set) {
+            std::vector<T> vec;
+            if(!readVector(in, vec)) {
+                return false;
+            }
+            set = std::set<T>(vec.begin(), vec.end());
+            return true;
+        }
+
+    }
+
+}
+
+#endif /* BinaryIO_hpp */
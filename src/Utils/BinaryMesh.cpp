@@ -0,0 +1,441 @@
+//
+//  BinaryMesh.cpp
+//  OptCuts
+//
+
+#include "BinaryMesh.hpp"
+
+#include <tbb/tbb.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef OPTCUTS_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace OptCuts {
+    namespace BinaryMesh {
+
+        namespace {
+            const char magic[8] = { 'O', 'C', 'M', 'E', 'S', 'H', 0, 0 };
+            const size_t headerSize = 64;
+            const size_t entrySize = 64;
+            const size_t nameSize = 16;
+
+            inline bool isLittleEndian(void)
+            {
+                const uint16_t one = 1;
+                return *reinterpret_cast<const uint8_t*>(&one) == 1;
+            }
+
+            template<typename T>
+            void putLE(char* dst, T val)
+            {
+                for(size_t byteI = 0; byteI < sizeof(T); byteI++) {
+                    dst[byteI] = static_cast<char>((static_cast<uint64_t>(val) >> (8 * byteI)) & 0xff);
+                }
+            }
+            template<typename T>
+            T getLE(const char* src)
+            {
+                uint64_t val = 0;
+                for(size_t byteI = 0; byteI < sizeof(T); byteI++) {
+                    val |= static_cast<uint64_t>(static_cast<uint8_t>(src[byteI])) << (8 * byteI);
+                }
+                return static_cast<T>(val);
+            }
+
+            // converts between host and little-endian order in place
+            void swapElements(char* data, size_t byteAmt, size_t elemSize)
+            {
+                if(isLittleEndian() || (elemSize == 1)) {
+                    return;
+                }
+                for(size_t elemI = 0; elemI < byteAmt; elemI += elemSize) {
+                    std::reverse(data + elemI, data + elemI + elemSize);
+                }
+            }
+
+            inline uint64_t alignUp(uint64_t offset)
+            {
+                return (offset + alignment - 1) / alignment * alignment;
+            }
+
+            inline size_t elemSizeOf(uint32_t elemType)
+            {
+                switch(elemType) {
+                    case ET_FLOAT64:
+                        return 8;
+                    case ET_INT32:
+                        return 4;
+                    case ET_BYTES:
+                        return 1;
+                    default:
+                        return 0;
+                }
+            }
+
+            struct SectionData {
+                SectionInfo info;
+                std::vector<char> raw;
+                std::vector<char> stored; // empty when raw is stored
+            };
+
+            template<typename Derived>
+            void addMatrix(std::vector<SectionData>& sections, const char* name, uint32_t elemType,
+                           const Eigen::MatrixBase<Derived>& mtr)
+            {
+                typedef typename Derived::Scalar Scalar;
+                if(mtr.size() == 0) {
+                    return;
+                }
+                sections.emplace_back();
+                SectionData& section = sections.back();
+                section.info.name = name;
+                section.info.elemType = elemType;
+                section.info.flags = 0;
+                section.info.rows = mtr.rows();
+                section.info.cols = mtr.cols();
+
+                const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rowMajor = mtr;
+                section.raw.resize(sizeof(Scalar) * rowMajor.size());
+                memcpy(section.raw.data(), rowMajor.data(), section.raw.size());
+                swapElements(section.raw.data(), section.raw.size(), sizeof(Scalar));
+                section.info.rawSize = section.raw.size();
+            }
+
+            void addBytes(std::vector<SectionData>& sections, const char* name, const char* begin, const char* end)
+            {
+                if(begin == end) {
+                    return;
+                }
+                sections.emplace_back();
+                SectionData& section = sections.back();
+                section.info.name = name;
+                section.info.elemType = ET_BYTES;
+                section.info.flags = 0;
+                section.info.rows = end - begin;
+                section.info.cols = 1;
+                section.raw.assign(begin, end);
+                section.info.rawSize = section.raw.size();
+            }
+
+            void addText(std::vector<SectionData>& sections, const char* name, const std::string& text)
+            {
+                addBytes(sections, name, text.data(), text.data() + text.size());
+            }
+
+            void compressSection(SectionData& section)
+            {
+#ifdef OPTCUTS_USE_ZSTD
+                section.stored.resize(ZSTD_compressBound(section.raw.size()));
+                const size_t storedSize = ZSTD_compress(section.stored.data(), section.stored.size(),
+                                                        section.raw.data(), section.raw.size(), 3);
+                if(ZSTD_isError(storedSize) || (storedSize >= section.raw.size())) {
+                    section.stored.clear();
+                    return;
+                }
+                section.stored.resize(storedSize);
+                section.info.flags |= SF_ZSTD;
+#endif
+            }
+
+            bool writeSections(const std::string& filePath, std::vector<SectionData>& sections, bool compress)
+            {
+                if(compress) {
+                    tbb::parallel_for(0, (int)sections.size(), 1, [&](int sectionI) {
+                        compressSection(sections[sectionI]);
+                    });
+                }
+
+                uint64_t offset = alignUp(headerSize + entrySize * sections.size());
+                for(auto& sectionI : sections) {
+                    sectionI.info.offset = offset;
+                    sectionI.info.storedSize = sectionI.stored.empty() ? sectionI.raw.size() : sectionI.stored.size();
+                    offset = alignUp(offset + sectionI.info.storedSize);
+                }
+
+                std::vector<char> head(headerSize + entrySize * sections.size(), 0);
+                memcpy(head.data(), magic, sizeof(magic));
+                putLE<uint32_t>(head.data() + 8, formatVersion);
+                putLE<uint32_t>(head.data() + 12, static_cast<uint32_t>(sections.size()));
+                for(size_t sectionI = 0; sectionI < sections.size(); sectionI++) {
+                    const SectionInfo& info = sections[sectionI].info;
+                    char* entry = head.data() + headerSize + entrySize * sectionI;
+                    memcpy(entry, info.name.data(), std::min(info.name.size(), nameSize));
+                    putLE<uint32_t>(entry + 16, info.elemType);
+                    putLE<uint32_t>(entry + 20, info.flags);
+                    putLE<uint64_t>(entry + 24, info.rows);
+                    putLE<uint64_t>(entry + 32, info.cols);
+                    putLE<uint64_t>(entry + 40, info.offset);
+                    putLE<uint64_t>(entry + 48, info.storedSize);
+                    putLE<uint64_t>(entry + 56, info.rawSize);
+                }
+
+                std::ofstream file(filePath, std::ios::binary);
+                if(!file.is_open()) {
+                    std::cout << "failed to create " << filePath << std::endl;
+                    return false;
+                }
+                file.write(head.data(), head.size());
+                uint64_t written = head.size();
+                const std::vector<char> padding(alignment, 0);
+                for(const auto& sectionI : sections) {
+                    file.write(padding.data(), sectionI.info.offset - written);
+                    const std::vector<char>& data = sectionI.stored.empty() ? sectionI.raw : sectionI.stored;
+                    file.write(data.data(), data.size());
+                    written = sectionI.info.offset + data.size();
+                }
+                file.close();
+                if(!file) {
+                    std::cout << "failed to write " << filePath << std::endl;
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        bool compressionAvailable(void)
+        {
+#ifdef OPTCUTS_USE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        bool write(const std::string& filePath, const Result& result, bool compress)
+        {
+            std::vector<SectionData> sections;
+            addMatrix(sections, "V", ET_FLOAT64, result.V);
+            addMatrix(sections, "F", ET_INT32, result.F);
+            addMatrix(sections, "UV", ET_FLOAT64, result.UV);
+            addMatrix(sections, "FUV", ET_INT32, result.FUV);
+            addMatrix(sections, "cohE", ET_INT32, result.cohE);
+            addMatrix(sections, "chartId", ET_INT32, result.chartId);
+            std::ostringstream meta;
+            meta.precision(17);
+            for(const auto& entryI : result.meta) {
+                meta << entryI.first << " " << entryI.second << "\n";
+            }
+            addText(sections, "meta", meta.str());
+
+            return writeSections(filePath, sections, compress);
+        }
+
+        bool read(const std::string& filePath, Result& result)
+        {
+            Reader reader(filePath);
+            if(!reader.isValid()) {
+                return false;
+            }
+
+            result = Result();
+            if(reader.find("V") && !reader.getMatrix("V", result.V)) { return false; }
+            if(reader.find("F") && !reader.getMatrix("F", result.F)) { return false; }
+            if(reader.find("UV") && !reader.getMatrix("UV", result.UV)) { return false; }
+            if(reader.find("FUV") && !reader.getMatrix("FUV", result.FUV)) { return false; }
+            if(reader.find("cohE") && !reader.getMatrix("cohE", result.cohE)) { return false; }
+            if(reader.find("chartId") && !reader.getMatrix("chartId", result.chartId)) { return false; }
+            if(reader.find("meta") && !reader.getMeta(result.meta)) { return false; }
+            return true;
+        }
+
+        bool writeSelection(const std::string& filePath, const std::vector<char>& selected, bool compress)
+        {
+            std::vector<char> mask((selected.size() + 7) / 8, 0);
+            tbb::parallel_for(0, (int)mask.size(), 1, [&](int byteI) {
+                const size_t vI_end = std::min(selected.size(), static_cast<size_t>(byteI) * 8 + 8);
+                for(size_t vI = static_cast<size_t>(byteI) * 8; vI < vI_end; vI++) {
+                    if(selected[vI]) {
+                        mask[byteI] |= static_cast<char>(1 << (vI % 8));
+                    }
+                }
+            });
+
+            std::vector<SectionData> sections;
+            addBytes(sections, "selectedMask", mask.data(), mask.data() + mask.size());
+            return writeSections(filePath, sections, compress);
+        }
+
+        bool readSelection(const std::string& filePath, int vertAmt, std::vector<char>& selected)
+        {
+            Reader reader(filePath);
+            if(!reader.isValid()) {
+                return false;
+            }
+
+            selected.assign(vertAmt, 0);
+            if(const SectionInfo* section = reader.find("selectedMask")) {
+                std::vector<char> bytes;
+                if((section->elemType != ET_BYTES) || !reader.getBytes(*section, bytes)) {
+                    return false;
+                }
+                const int vertAmt_mask = static_cast<int>(std::min<uint64_t>(vertAmt, bytes.size() * 8));
+                tbb::parallel_for(0, vertAmt_mask, 1, [&](int vI) {
+                    selected[vI] = (bytes[vI / 8] >> (vI % 8)) & 1;
+                });
+                return true;
+            }
+            if(reader.find("selected")) {
+                Eigen::VectorXi inds;
+                if(!reader.getMatrix("selected", inds)) {
+                    return false;
+                }
+                for(int indI = 0; indI < inds.size(); indI++) {
+                    if((inds[indI] >= 0) && (inds[indI] < vertAmt)) {
+                        selected[inds[indI]] = 1;
+                    }
+                }
+                return true;
+            }
+            std::cout << "no selection in " << filePath << std::endl;
+            return false;
+        }
+
+        Reader::Reader(const std::string& filePath) :
+            file(filePath), version(0), valid(false)
+        {
+            if(!file.isOpen()) {
+                std::cout << "failed to open " << filePath << std::endl;
+                return;
+            }
+            const char* data = file.begin();
+            const uint64_t fileSize = file.size();
+            if((fileSize < headerSize) || memcmp(data, magic, sizeof(magic))) {
+                std::cout << filePath << " is not a binary mesh file" << std::endl;
+                return;
+            }
+            version = getLE<uint32_t>(data + 8);
+            if(version > formatVersion) {
+                std::cout << filePath << " has the newer format version " << version << std::endl;
+                return;
+            }
+            const uint64_t sectionAmt = getLE<uint32_t>(data + 12);
+            if(headerSize + entrySize * sectionAmt > fileSize) {
+                std::cout << "truncated section table in " << filePath << std::endl;
+                return;
+            }
+
+            sections.resize(sectionAmt);
+            for(uint64_t sectionI = 0; sectionI < sectionAmt; sectionI++) {
+                const char* entry = data + headerSize + entrySize * sectionI;
+                SectionInfo& info = sections[sectionI];
+                info.name.assign(entry, std::find(entry, entry + nameSize, '\0'));
+                info.elemType = getLE<uint32_t>(entry + 16);
+                info.flags = getLE<uint32_t>(entry + 20);
+                info.rows = getLE<uint64_t>(entry + 24);
+                info.cols = getLE<uint64_t>(entry + 32);
+                info.offset = getLE<uint64_t>(entry + 40);
+                info.storedSize = getLE<uint64_t>(entry + 48);
+                info.rawSize = getLE<uint64_t>(entry + 56);
+
+                // overflow-safe bounds, the element checks are left to getElements()
+                if((info.offset > fileSize) || (info.storedSize > fileSize - info.offset) ||
+                   (!(info.flags & SF_ZSTD) && (info.storedSize != info.rawSize)))
+                {
+                    std::cout << "corrupted section " << info.name << " in " << filePath << std::endl;
+                    sections.clear();
+                    return;
+                }
+            }
+            valid = true;
+        }
+
+        const SectionInfo* Reader::find(const std::string& name) const
+        {
+            for(const auto& sectionI : sections) {
+                if(sectionI.name == name) {
+                    return &sectionI;
+                }
+            }
+            return NULL;
+        }
+
+        const void* Reader::rawData(const SectionInfo& section) const
+        {
+            if(section.flags & SF_ZSTD) {
+                return NULL;
+            }
+            return file.begin() + section.offset;
+        }
+
+        bool Reader::getBytes(const SectionInfo& section, std::vector<char>& bytes) const
+        {
+            const char* stored = file.begin() + section.offset;
+            if(!(section.flags & SF_ZSTD)) {
+                bytes.assign(stored, stored + section.storedSize);
+                return true;
+            }
+#ifdef OPTCUTS_USE_ZSTD
+            bytes.resize(section.rawSize);
+            const size_t rawSize = ZSTD_decompress(bytes.data(), bytes.size(), stored, section.storedSize);
+            if(ZSTD_isError(rawSize) || (rawSize != section.rawSize)) {
+                std::cout << "failed to decompress section " << section.name << std::endl;
+                bytes.clear();
+                return false;
+            }
+            return true;
+#else
+            std::cout << "section " << section.name << " is compressed, build with OPTCUTS_USE_ZSTD to read it" << std::endl;
+            return false;
+#endif
+        }
+
+        const char* Reader::getElements(const std::string& name, uint32_t elemType, size_t elemSize,
+                                        uint64_t& rows, uint64_t& cols, std::vector<char>& buffer) const
+        {
+            const SectionInfo* section = find(name);
+            if(!section || (section->elemType != elemType) || (elemSizeOf(elemType) != elemSize)) {
+                return NULL;
+            }
+            rows = section->rows;
+            cols = section->cols;
+            if((cols != 0) && (rows > section->rawSize / elemSize / cols)) {
+                return NULL;
+            }
+            if(rows * cols * elemSize != section->rawSize) {
+                return NULL;
+            }
+
+            if(!(section->flags & SF_ZSTD) && isLittleEndian()) {
+                return file.begin() + section->offset;
+            }
+            if(!getBytes(*section, buffer)) {
+                return NULL;
+            }
+            swapElements(buffer.data(), buffer.size(), elemSize);
+            return buffer.data();
+        }
+
+        bool Reader::getMeta(std::map<std::string, double>& meta) const
+        {
+            const SectionInfo* section = find("meta");
+            std::vector<char> bytes;
+            if(!section || (section->elemType != ET_BYTES) || !getBytes(*section, bytes)) {
+                return false;
+            }
+            meta.clear();
+            std::istringstream text(std::string(bytes.begin(), bytes.end()));
+            std::string key, val;
+            while(text >> key) {
+                // strtod also reads back inf and nan
+                if(!(text >> val)) {
+                    return false;
+                }
+                char* valEnd = NULL;
+                meta[key] = strtod(val.c_str(), &valEnd);
+                if(*valEnd != '\0') {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    }
+}
@@ -0,0 +1,143 @@
+//
+//  BinaryMesh.hpp
+//  OptCuts
+//
+
+#ifndef BinaryMesh_hpp
+#define BinaryMesh_hpp
+
+#include "MappedFile.hpp"
+
+#include <Eigen/Eigen>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace OptCuts {
+
+    // versioned binary container of a mesh with its UV map and seams for handing results
+    // to other tools without reparsing OBJ files, little-endian with the layout
+    //   header, 64 bytes: magic "OCMESH\0\0", uint32 version, uint32 section amount, reserved
+    //   section table, 64 bytes per section: char name[16] (zero-padded), uint32 element type,
+    //     uint32 flags, uint64 rows, cols, offset, stored size and raw size
+    //   section data, row-major, each section starting at a multiple of 64 bytes so that
+    //     uncompressed ones can be used in place from a memory-mapped file
+    // sections are looked up by name so that newer versions can add some, read() ignores unknown ones
+    namespace BinaryMesh {
+
+        const uint32_t formatVersion = 1;
+        const size_t alignment = 64;
+
+        enum ElemType {
+            ET_FLOAT64 = 1,
+            ET_INT32 = 2,
+            ET_BYTES = 3
+        };
+
+        enum SectionFlag {
+            SF_ZSTD = 1 // stored as one zstd frame of the raw data
+        };
+
+        struct SectionInfo {
+            std::string name;
+            uint32_t elemType;
+            uint32_t flags;
+            uint64_t rows, cols;
+            uint64_t offset, storedSize, rawSize;
+        };
+
+        // the sections written by write() and filled by read(), empty ones are skipped
+        struct Result {
+            Eigen::MatrixXd V; // "V": 3D vertex positions
+            Eigen::MatrixXi F; // "F": triangles in V
+            Eigen::MatrixXd UV; // "UV": 2D vertex positions
+            Eigen::MatrixXi FUV; // "FUV": triangles in UV, in the same order as F
+            Eigen::MatrixXi cohE; // "cohE": seams as cohesive edges in UV indices, see TriMesh::cohE
+            Eigen::VectorXi chartId; // "chartId": per-triangle chart index
+            std::map<std::string, double> meta; // "meta": text lines of "key value"
+        };
+
+        // whether write() can compress, i.e. built with OPTCUTS_USE_ZSTD
+        bool compressionAvailable(void);
+
+        // with compress, each section is zstd-compressed if that makes it smaller,
+        // sections are stored raw when compression is not available
+        bool write(const std::string& filePath, const Result& result, bool compress = false);
+        bool read(const std::string& filePath, Result& result);
+
+        // vertex selections of the regional seam placement in the same container, either
+        // "selectedMask": bytes with bit vI % 8 of byte vI / 8 set for selected vertices, or
+        // "selected": int32 vertex indices in one column,
+        // writeSelection() writes the bitmap, readSelection() gives one entry per vertex
+        // and ignores vertices outside [0, vertAmt)
+        bool writeSelection(const std::string& filePath, const std::vector<char>& selected, bool compress = false);
+        bool readSelection(const std::string& filePath, int vertAmt, std::vector<char>& selected);
+
+        // section access on the memory-mapped file
+        class Reader {
+        protected:
+            MappedFile file;
+            uint32_t version;
+            std::vector<SectionInfo> sections;
+            bool valid;
+
+        public:
+            explicit Reader(const std::string& filePath);
+
+            bool isValid(void) const { return valid; }
+            uint32_t getVersion(void) const { return version; }
+            const std::vector<SectionInfo>& getSections(void) const { return sections; }
+            const SectionInfo* find(const std::string& name) const;
+
+            // the row-major little-endian data of an uncompressed section in the mapping,
+            // NULL for compressed sections
+            const void* rawData(const SectionInfo& section) const;
+            // the raw data of any section, decompressed if necessary
+            bool getBytes(const SectionInfo& section, std::vector<char>& bytes) const;
+
+            // false if the section is missing or has another element type,
+            // fixed-size dimensions of the output have to match
+            template<typename Derived>
+            bool getMatrix(const std::string& name, Eigen::PlainObjectBase<Derived>& mtr) const;
+            bool getMeta(std::map<std::string, double>& meta) const;
+
+        protected:
+            // the elements of a section in host byte order, either in the mapping or in buffer,
+            // NULL if the section is missing, has another element type or is corrupted
+            const char* getElements(const std::string& name, uint32_t elemType, size_t elemSize,
+                                    uint64_t& rows, uint64_t& cols, std::vector<char>& buffer) const;
+        };
+
+        template<typename Derived>
+        bool Reader::getMatrix(const std::string& name, Eigen::PlainObjectBase<Derived>& mtr) const
+        {
+            typedef typename Derived::Scalar Scalar;
+            static_assert(std::is_same<Scalar, double>::value || std::is_same<Scalar, int>::value,
+                          "sections hold doubles or 32-bit integers");
+            static_assert(sizeof(int) == 4, "int sections are 32-bit");
+
+            uint64_t rows, cols;
+            std::vector<char> buffer;
+            const char* elements = getElements(name, std::is_same<Scalar, double>::value ? ET_FLOAT64 : ET_INT32,
+                                               sizeof(Scalar), rows, cols, buffer);
+            if(!elements) {
+                return false;
+            }
+            if(((Derived::RowsAtCompileTime != Eigen::Dynamic) && (rows != Derived::RowsAtCompileTime)) ||
+               ((Derived::ColsAtCompileTime != Eigen::Dynamic) && (cols != Derived::ColsAtCompileTime)))
+            {
+                return false;
+            }
+            typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMtr;
+            mtr = Eigen::Map<const RowMajorMtr>(reinterpret_cast<const Scalar*>(elements), rows, cols);
+            return true;
+        }
+
+    }
+
+}
+
+#endif /* BinaryMesh_hpp */
@@ -0,0 +1,93 @@
+//
+//  CandidateBudget.hpp
+//  OptCuts
+//
+
+#ifndef CandidateBudget_hpp
+#define CandidateBudget_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+namespace OptCuts {
+
+    // decides how many of the sorted split candidates get the expensive local solve
+    // in each query: pow(candAmt, filterExp) by default, optionally adapting to the
+    // ranks at which the winners were found by keeping twice the worst recent
+    // winner rank, and optionally capped by a time budget per query, never going
+    // below an exploration floor of a quarter of the default amount when limited,
+    // every sampleInterval-th query of a limited budget evaluates all candidates so
+    // that the regret of the budget can be measured and uncensored ranks are recorded
+    class CandidateBudget {
+    public:
+        double filterExp;
+        int minCandAmt;
+        int sampleInterval; // 0: never evaluate all candidates for sampling
+        size_t rankWindow; // how many recent winner ranks to keep
+        double timeBudget; // seconds per query for the local solves, 0: unlimited
+        bool adaptive; // whether the amount follows the recent winner ranks
+
+    protected:
+        std::deque<int> recentWinRanks;
+        double secPerCand; // wall-clock seconds per evaluated candidate
+        int queryAmt;
+
+    public:
+        CandidateBudget(double p_filterExp = 0.8, int p_minCandAmt = 2, int p_sampleInterval = 20,
+                        size_t p_rankWindow = 10, double p_timeBudget = 0.0, bool p_adaptive = false) :
+            filterExp(p_filterExp), minCandAmt(p_minCandAmt), sampleInterval(p_sampleInterval),
+            rankWindow(p_rankWindow), timeBudget(p_timeBudget), adaptive(p_adaptive), secPerCand(0.0), queryAmt(0) {}
+
+        // the amount the original fixed filtering would evaluate
+        int defaultAmt(int candAmt) const {
+            return std::max(minCandAmt, static_cast<int>(std::pow(candAmt, filterExp)));
+        }
+
+        // whether the amount can differ from defaultAmt()
+        bool isLimited(void) const { return adaptive || (timeBudget > 0.0); }
+
+        int explorationFloor(int candAmt) const {
+            return std::max(minCandAmt, static_cast<int>(std::ceil(0.25 * defaultAmt(candAmt))));
+        }
+
+        // amount of top-ranked candidates to evaluate out of candAmt
+        int budget(int candAmt) const {
+            int amt = defaultAmt(candAmt);
+            const int floorAmt = explorationFloor(candAmt);
+            if(adaptive && !recentWinRanks.empty()) {
+                const int maxRank = *std::max_element(recentWinRanks.begin(), recentWinRanks.end());
+                // winners found near the end of the budget push it up
+                amt = std::max(floorAmt, 2 * (maxRank + 1));
+            }
+            if((timeBudget > 0.0) && (secPerCand > 0.0)) {
+                amt = std::min(amt, std::max(floorAmt, static_cast<int>(timeBudget / secPerCand)));
+            }
+            return std::min(amt, candAmt);
+        }
+
+        // whether the upcoming query should evaluate all candidates to measure regret
+        bool sampleFullEval(void) const {
+            return isLimited() && (sampleInterval > 0) && (queryAmt % sampleInterval == sampleInterval - 1);
+        }
+
+        void record(int evalAmt, int winRank, double seconds) {
+            queryAmt++;
+            if(winRank >= 0) {
+                recentWinRanks.push_back(winRank);
+                while(recentWinRanks.size() > rankWindow) {
+                    recentWinRanks.pop_front();
+                }
+            }
+            if(evalAmt > 0) {
+                const double curSecPerCand = seconds / evalAmt;
+                secPerCand = ((secPerCand > 0.0) ? (0.5 * (secPerCand + curSecPerCand)) : curSecPerCand);
+            }
+        }
+
+        int getQueryAmt(void) const { return queryAmt; }
+    };
+
+}
+
+#endif /* CandidateBudget_hpp */
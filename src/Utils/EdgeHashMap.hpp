@@ -0,0 +1,196 @@
+//
+//  EdgeHashMap.hpp
+//  OptCuts
+//
+
+#ifndef EdgeHashMap_hpp
+#define EdgeHashMap_hpp
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace OptCuts {
+
+    // open-addressing (linear probing) hash map from a directed edge (vI0, vI1)
+    // with non-negative vertex indices to an int, used as a flat replacement of
+    // std::map<std::pair<int, int>, int> for the mesh indices,
+    // edges are hashed by their packed 64-bit id and stored in a single array,
+    // erase uses backward shifting so that no tombstones are left,
+    // iteration order is unspecified and iterators are invalidated by insert and erase
+    class EdgeHashMap {
+    public:
+        typedef std::pair<int, int> key_type;
+        typedef std::pair<key_type, int> value_type;
+
+        template<typename T>
+        class Iterator {
+            friend class EdgeHashMap;
+        public:
+            Iterator(void) : slot(NULL), slotEnd(NULL) {}
+            Iterator(T* p_slot, T* p_slotEnd) : slot(p_slot), slotEnd(p_slotEnd) { skipEmpty(); }
+            template<typename T_other>
+            Iterator(const Iterator<T_other>& other) : slot(other.slot), slotEnd(other.slotEnd) {}
+
+            T& operator*(void) const { return *slot; }
+            T* operator->(void) const { return slot; }
+            Iterator& operator++(void) { ++slot; skipEmpty(); return *this; }
+            template<typename T_other>
+            bool operator==(const Iterator<T_other>& other) const { return slot == other.slot; }
+            template<typename T_other>
+            bool operator!=(const Iterator<T_other>& other) const { return slot != other.slot; }
+
+        public:
+            T* slot;
+            T* slotEnd;
+
+        protected:
+            void skipEmpty(void) {
+                while((slot != slotEnd) && (slot->first.first < 0)) {
+                    ++slot;
+                }
+            }
+        };
+        typedef Iterator<value_type> iterator;
+        typedef Iterator<const value_type> const_iterator;
+
+    protected:
+        std::vector<value_type> slots; // empty slots have negative keys
+        size_t elemAmt;
+        int capacityExp;
+
+    public:
+        EdgeHashMap(void) : elemAmt(0), capacityExp(0) {}
+
+        static uint64_t packEdge(const key_type& edge) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(edge.first)) << 32) |
+                static_cast<uint32_t>(edge.second);
+        }
+
+        size_t size(void) const { return elemAmt; }
+        bool empty(void) const { return elemAmt == 0; }
+
+        void clear(void) {
+            slots.resize(0);
+            elemAmt = 0;
+            capacityExp = 0;
+        }
+
+        void reserve(size_t amt) {
+            int exp = 4;
+            while((static_cast<size_t>(1) << exp) < amt * 2) {
+                exp++;
+            }
+            if(exp > capacityExp) {
+                rehash(exp);
+            }
+        }
+
+        iterator begin(void) { return iterator(slots.data(), slots.data() + slots.size()); }
+        iterator end(void) { return iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+        const_iterator begin(void) const { return const_iterator(slots.data(), slots.data() + slots.size()); }
+        const_iterator end(void) const { return const_iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+
+        iterator find(const key_type& edge) {
+            const size_t slotI = findSlot(edge);
+            return ((slotI < slots.size()) ? iterator(slots.data() + slotI, slots.data() + slots.size()) : end());
+        }
+        const_iterator find(const key_type& edge) const {
+            const size_t slotI = findSlot(edge);
+            return ((slotI < slots.size()) ? const_iterator(slots.data() + slotI, slots.data() + slots.size()) : end());
+        }
+        size_t count(const key_type& edge) const { return (findSlot(edge) < slots.size()); }
+
+        int& operator[](const key_type& edge) {
+            assert((edge.first >= 0) && (edge.second >= 0));
+
+            if((elemAmt + 1) * 2 > slots.size()) {
+                rehash(std::max(4, capacityExp + 1));
+            }
+
+            const size_t mask = slots.size() - 1;
+            size_t slotI = hash(edge);
+            while(slots[slotI].first.first >= 0) {
+                if(slots[slotI].first == edge) {
+                    return slots[slotI].second;
+                }
+                slotI = (slotI + 1) & mask;
+            }
+            slots[slotI].first = edge;
+            slots[slotI].second = 0;
+            elemAmt++;
+            return slots[slotI].second;
+        }
+
+        size_t erase(const key_type& edge) {
+            const size_t slotI = findSlot(edge);
+            if(slotI < slots.size()) {
+                eraseSlot(slotI);
+                return 1;
+            }
+            return 0;
+        }
+        void erase(const_iterator it) {
+            assert(it.slot != slots.data() + slots.size());
+            eraseSlot(it.slot - slots.data());
+        }
+
+    protected:
+        size_t hash(const key_type& edge) const {
+            // Fibonacci hashing of the packed edge id
+            return static_cast<size_t>((packEdge(edge) * 0x9E3779B97F4A7C15ull) >> (64 - capacityExp));
+        }
+
+        size_t findSlot(const key_type& edge) const {
+            if(slots.empty() || (edge.first < 0)) {
+                return slots.size();
+            }
+
+            const size_t mask = slots.size() - 1;
+            size_t slotI = hash(edge);
+            while(slots[slotI].first.first >= 0) {
+                if(slots[slotI].first == edge) {
+                    return slotI;
+                }
+                slotI = (slotI + 1) & mask;
+            }
+            return slots.size();
+        }
+
+        void eraseSlot(size_t slotI) {
+            // shift the following entries of the probing chain backward
+            const size_t mask = slots.size() - 1;
+            size_t nextI = (slotI + 1) & mask;
+            while(slots[nextI].first.first >= 0) {
+                const size_t homeI = hash(slots[nextI].first);
+                // move if the home slot of nextI is not cyclically within (slotI, nextI]
+                if(((nextI - homeI) & mask) >= ((nextI - slotI) & mask)) {
+                    slots[slotI] = slots[nextI];
+                    slotI = nextI;
+                }
+                nextI = (nextI + 1) & mask;
+            }
+            slots[slotI].first = key_type(-1, -1);
+            elemAmt--;
+        }
+
+        void rehash(int p_capacityExp) {
+            std::vector<value_type> oldSlots(static_cast<size_t>(1) << p_capacityExp,
+                                             value_type(key_type(-1, -1), 0));
+            oldSlots.swap(slots);
+            capacityExp = p_capacityExp;
+            elemAmt = 0;
+            for(const auto& slot : oldSlots) {
+                if(slot.first.first >= 0) {
+                    (*this)[slot.first] = slot.second;
+                }
+            }
+        }
+    };
+
+}
+
+#endif /* EdgeHashMap_hpp */
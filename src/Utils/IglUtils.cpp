@@ -6,9 +6,13 @@
 //
 
 #include "IglUtils.hpp"
+#include "MeshGraph.hpp"
 
+#include <igl/boundary_loop.h>
+#include <igl/map_vertices_to_circle.h>
 #include <tbb/tbb.h>
 
+#include <algorithm>
 #include <set>
 
 namespace OptCuts {
@@ -169,6 +173,115 @@ namespace OptCuts {
         }
     }
     
+    void IglUtils::harmonicParam_multiComp(const Eigen::MatrixXd& V, const std::vector<Eigen::MatrixXi>& F_component,
+                                           Eigen::MatrixXd& UV)
+    {
+        const int compAmt = static_cast<int>(F_component.size());
+        std::vector<std::vector<int>> verts_comp(compAmt);
+        std::vector<Eigen::MatrixXd> UV_comp(compAmt);
+        tbb::parallel_for(0, compAmt, 1, [&](int compI) {
+            const Eigen::MatrixXi& F_comp = F_component[compI];
+            std::vector<int>& verts = verts_comp[compI];
+            verts.assign(F_comp.data(), F_comp.data() + F_comp.size());
+            std::sort(verts.begin(), verts.end());
+            verts.erase(std::unique(verts.begin(), verts.end()), verts.end());
+            auto localInd = [&verts](int vI) {
+                return static_cast<int>(std::lower_bound(verts.begin(), verts.end(), vI) - verts.begin());
+            };
+            
+            std::vector<std::vector<int>> bnd_all;
+            igl::boundary_loop(F_comp, bnd_all);
+            assert(!bnd_all.empty() && "component is not cut to disk!");
+            int longest_bnd_id = 0;
+            for(int bnd_id = 1; bnd_id < bnd_all.size(); bnd_id++) {
+                if(bnd_all[longest_bnd_id].size() < bnd_all[bnd_id].size()) {
+                    longest_bnd_id = bnd_id;
+                }
+            }
+            const Eigen::VectorXi bnd = Eigen::VectorXi::Map(bnd_all[longest_bnd_id].data(),
+                                                              bnd_all[longest_bnd_id].size());
+            Eigen::MatrixXd bnd_uv;
+            igl::map_vertices_to_circle(V, bnd, bnd_uv);
+            
+            // split the vertices into free (>= 0) and fixed (< 0) unknowns
+            std::vector<int> freeInd(verts.size(), 0);
+            for(int bndI = 0; bndI < bnd.size(); bndI++) {
+                freeInd[localInd(bnd[bndI])] = -bndI - 1;
+            }
+            int freeAmt = 0;
+            for(auto& freeIndI : freeInd) {
+                if(freeIndI >= 0) {
+                    freeIndI = freeAmt++;
+                }
+            }
+            
+            UV_comp[compI].resize(verts.size(), 2);
+            for(int bndI = 0; bndI < bnd.size(); bndI++) {
+                UV_comp[compI].row(localInd(bnd[bndI])) = bnd_uv.row(bndI);
+            }
+            if(!freeAmt) {
+                return;
+            }
+            
+            Eigen::MatrixXi F_local(F_comp.rows(), 3);
+            for(int triI = 0; triI < F_comp.rows(); triI++) {
+                for(int i = 0; i < 3; i++) {
+                    F_local(triI, i) = localInd(F_comp(triI, i));
+                }
+            }
+            Eigen::SparseMatrix<double> L;
+            computeUniformLaplacian(F_local, L);
+            
+            // -L_ff x_f = L_fb x_b
+            std::vector<Eigen::Triplet<double>> triplet;
+            triplet.reserve(L.nonZeros());
+            Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(freeAmt, 2);
+            for(int colI = 0; colI < L.outerSize(); colI++) {
+                for(Eigen::SparseMatrix<double>::InnerIterator it(L, colI); it; ++it) {
+                    const int rowInd = freeInd[it.row()], colInd = freeInd[it.col()];
+                    if(rowInd < 0) {
+                        continue;
+                    }
+                    if(colInd >= 0) {
+                        triplet.emplace_back(rowInd, colInd, -it.value());
+                    }
+                    else {
+                        rhs.row(rowInd) += it.value() * bnd_uv.row(-colInd - 1);
+                    }
+                }
+            }
+            Eigen::SparseMatrix<double> A(freeAmt, freeAmt);
+            A.setFromTriplets(triplet.begin(), triplet.end());
+            
+            Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
+            solver.compute(A);
+            if(solver.info() != Eigen::Success) {
+                assert(0 && "LDLT decomposition on uniform Laplacian failed!");
+                return;
+            }
+            const Eigen::MatrixXd UV_free = solver.solve(rhs);
+            for(int vI = 0; vI < verts.size(); vI++) {
+                if(freeInd[vI] >= 0) {
+                    UV_comp[compI].row(vI) = UV_free.row(freeInd[vI]);
+                }
+            }
+        });
+        
+        // grid layout
+        int UVGridDim = 0;
+        do {
+            ++UVGridDim;
+        } while(UVGridDim * UVGridDim < compAmt);
+        
+        UV.setZero(V.rows(), 2);
+        for(int compI = 0; compI < compAmt; compI++) {
+            const Eigen::RowVector2d offset(compI % UVGridDim * 2.1, compI / UVGridDim * 2.1);
+            for(int vI = 0; vI < verts_comp[compI].size(); vI++) {
+                UV.row(verts_comp[compI][vI]) = UV_comp[compI].row(vI) + offset;
+            }
+        }
+    }
+    
     void IglUtils::mapTriangleTo2D(const Eigen::Vector3d v[3], Eigen::Vector2d u[3])
     {
         const Eigen::Vector3d e[2] = {
@@ -769,15 +882,46 @@ namespace OptCuts {
         outFile.close();
     }
     
-    void IglUtils::smoothVertField(const TriMesh& mesh, Eigen::VectorXd& field)
+    void IglUtils::smoothVertField(const TriMesh& mesh, Eigen::VectorXd& field, int iterAmt)
     {
         assert(field.size() == mesh.V.rows());
-        Eigen::VectorXd field_copy = field;
-        for(int vI = 0; vI < field.size(); vI++) {
-            for(const auto nbVI : mesh.vNeighbor[vI]) {
-                field[vI] += field_copy[nbVI];
+        MeshGraph(mesh.vNeighbor, mesh.V_rest).smoothField(field, iterAmt);
+    }
+    
+    void IglUtils::splitFaceComponents(const Eigen::MatrixXi& F, const Eigen::VectorXi& C,
+                                       std::vector<Eigen::MatrixXi>& F_component)
+    {
+        assert(C.size() == F.rows());
+        std::vector<int> faceCount(F_component.size(), 0);
+        for(int triI = 0; triI < F.rows(); triI++) {
+            faceCount[C[triI]]++;
+        }
+        for(int componentI = 0; componentI < F_component.size(); componentI++) {
+            F_component[componentI].resize(faceCount[componentI], 3);
+            faceCount[componentI] = 0;
+        }
+        for(int triI = 0; triI < F.rows(); triI++) {
+            F_component[C[triI]].row(faceCount[C[triI]]++) = F.row(triI);
+        }
+    }
+    
+    int IglUtils::eulerCharacteristic(const Eigen::MatrixXi& F)
+    {
+        std::vector<int> verts(F.data(), F.data() + F.size());
+        std::sort(verts.begin(), verts.end());
+        
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(F.rows() * 3);
+        for(int triI = 0; triI < F.rows(); triI++) {
+            for(int i = 0; i < 3; i++) {
+                const int vI = F(triI, i), vI_post = F(triI, (i + 1) % 3);
+                edges.emplace_back(std::min(vI, vI_post), std::max(vI, vI_post));
             }
-            field[vI] /= mesh.vNeighbor[vI].size() + 1;
         }
+        std::sort(edges.begin(), edges.end());
+        
+        return static_cast<int>(std::unique(verts.begin(), verts.end()) - verts.begin()) -
+            static_cast<int>(std::unique(edges.begin(), edges.end()) - edges.begin()) +
+            static_cast<int>(F.rows());
     }
 }
@@ -30,6 +30,12 @@ namespace OptCuts {
         static void fixedBoundaryParam_MVC(Eigen::SparseMatrix<double> A, const Eigen::VectorXi& bnd,
                                            const Eigen::MatrixXd& bnd_uv, Eigen::MatrixXd& UV_Tutte);
         
+        // uniform-weight harmonic map of each component with its longest boundary loop fixed on a unit circle,
+        // the components are solved in parallel with one factorization for both coordinates,
+        // and are then packed into a grid, UV has a row for each vertex in V
+        static void harmonicParam_multiComp(const Eigen::MatrixXd& V, const std::vector<Eigen::MatrixXi>& F_component,
+                                            Eigen::MatrixXd& UV);
+        
         static void mapTriangleTo2D(const Eigen::Vector3d v[3], Eigen::Vector2d u[3]);
         static void computeDeformationGradient(const Eigen::Vector3d v[3], const Eigen::Vector2d u[3], Eigen::Matrix2d& F);
         
@@ -116,7 +122,14 @@ namespace OptCuts {
         static void saveMesh_Seamster(const std::string& filePath,
                                       const Eigen::MatrixXd& V, const Eigen::MatrixXi& F);
         
-        static void smoothVertField(const TriMesh& mesh, Eigen::VectorXd& field);
+        // iterAmt steps of averaging each vertex value with those of its neighbors in mesh.vNeighbor
+        static void smoothVertField(const TriMesh& mesh, Eigen::VectorXd& field, int iterAmt = 1);
+        
+        // faces of each component in their original order, F_component must be sized to the component count
+        static void splitFaceComponents(const Eigen::MatrixXi& F, const Eigen::VectorXi& C,
+                                        std::vector<Eigen::MatrixXi>& F_component);
+        // V - E + F, counting only the vertices referenced by F
+        static int eulerCharacteristic(const Eigen::MatrixXi& F);
     };
     
 }
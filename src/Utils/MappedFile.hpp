@@ -0,0 +1,97 @@
+//
+//  MappedFile.hpp
+//  OptCuts
+//
+
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace OptCuts {
+
+    // the whole file as one read-only range of characters, memory-mapped where available
+    // and read into a buffer otherwise
+    class MappedFile {
+    protected:
+        const char* fileBegin;
+        size_t fileSize;
+        bool opened;
+#ifdef _WIN32
+        std::string buffer;
+#else
+        void* mapping;
+#endif
+
+    public:
+        explicit MappedFile(const std::string& filePath) :
+            fileBegin(NULL), fileSize(0), opened(false)
+        {
+#ifdef _WIN32
+            std::ifstream file(filePath, std::ios::binary);
+            if(!file.is_open()) {
+                return;
+            }
+            std::ostringstream content;
+            content << file.rdbuf();
+            buffer = content.str();
+            fileBegin = buffer.data();
+            fileSize = buffer.size();
+            opened = true;
+#else
+            mapping = MAP_FAILED;
+            const int fd = ::open(filePath.c_str(), O_RDONLY);
+            if(fd < 0) {
+                return;
+            }
+            struct stat fileStat;
+            if(fstat(fd, &fileStat) == 0) {
+                fileSize = static_cast<size_t>(fileStat.st_size);
+                if(fileSize == 0) {
+                    opened = true;
+                }
+                else {
+                    mapping = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if(mapping != MAP_FAILED) {
+                        madvise(mapping, fileSize, MADV_SEQUENTIAL);
+                        fileBegin = static_cast<const char*>(mapping);
+                        opened = true;
+                    }
+                }
+            }
+            ::close(fd);
+#endif
+        }
+
+        ~MappedFile(void)
+        {
+#ifndef _WIN32
+            if(mapping != MAP_FAILED) {
+                munmap(mapping, fileSize);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool isOpen(void) const { return opened; }
+        const char* begin(void) const { return fileBegin; }
+        const char* end(void) const { return fileBegin + fileSize; }
+        size_t size(void) const { return fileSize; }
+    };
+
+}
+
+#endif /* MappedFile_hpp */
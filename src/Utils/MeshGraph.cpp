@@ -0,0 +1,136 @@
+//
+//  MeshGraph.cpp
+//  OptCuts
+//
+
+#include "MeshGraph.hpp"
+
+#include <tbb/tbb.h>
+
+#include <algorithm>
+#include <cassert>
+#include <queue>
+
+namespace OptCuts {
+
+    MeshGraph::MeshGraph(void) : offset(1, 0) {}
+
+    MeshGraph::MeshGraph(const std::vector<std::set<int>>& vNeighbor, const Eigen::MatrixXd& V) {
+        assert(vNeighbor.size() == V.rows());
+
+        offset.resize(vNeighbor.size() + 1);
+        offset[0] = 0;
+        for(int vI = 0; vI < vNeighbor.size(); vI++) {
+            offset[vI + 1] = offset[vI] + static_cast<int>(vNeighbor[vI].size());
+        }
+        adjacency.resize(offset.back());
+        weight.resize(offset.back());
+        tbb::parallel_for(0, (int)vNeighbor.size(), 1, [&](int vI) {
+            int edgeI = offset[vI];
+            for(const auto& nbI : vNeighbor[vI]) {
+                adjacency[edgeI] = nbI;
+                weight[edgeI] = (V.row(vI) - V.row(nbI)).norm();
+                edgeI++;
+            }
+        });
+    }
+
+    int MeshGraph::vertAmt(void) const {
+        return static_cast<int>(offset.size()) - 1;
+    }
+
+    int MeshGraph::shortestPaths(const std::vector<int>& srcs, std::vector<double>& dist, std::vector<int>& parent,
+                                 const std::function<bool(int)>& isTarget) const
+    {
+        dist.resize(0);
+        dist.resize(vertAmt(), __DBL_MAX__);
+        parent.resize(0);
+        parent.resize(vertAmt(), -1);
+
+        // binary heap with lazy deletion, stale entries are skipped when popped
+        typedef std::pair<double, int> HeapEntry;
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+        for(const auto& srcI : srcs) {
+            assert((srcI >= 0) && (srcI < vertAmt()));
+            dist[srcI] = 0.0;
+            heap.emplace(0.0, srcI);
+        }
+
+        while(!heap.empty()) {
+            const HeapEntry top = heap.top();
+            heap.pop();
+            const int u = top.second;
+            if(top.first > dist[u]) {
+                continue;
+            }
+            if(isTarget && isTarget(u)) {
+                return u;
+            }
+
+            for(int edgeI = offset[u]; edgeI < offset[u + 1]; edgeI++) {
+                const int v = adjacency[edgeI];
+                const double dist_v = dist[u] + weight[edgeI];
+                if(dist_v < dist[v]) {
+                    dist[v] = dist_v;
+                    parent[v] = u;
+                    heap.emplace(dist_v, v);
+                }
+            }
+        }
+        return -1;
+    }
+
+    void MeshGraph::farthestPaths(const std::vector<int>& srcs, std::vector<std::vector<int>>& paths) const {
+        paths.resize(0);
+        paths.resize(srcs.size());
+        tbb::parallel_for(0, (int)srcs.size(), 1, [&](int srcI) {
+            std::vector<double> dist;
+            std::vector<int> parent;
+            shortestPaths(std::vector<int>(1, srcs[srcI]), dist, parent);
+            const int vI_farthest = farthestVert(dist);
+            if(vI_farthest >= 0) {
+                tracePath(parent, vI_farthest, paths[srcI]);
+            }
+        });
+    }
+
+    void MeshGraph::smoothField(Eigen::VectorXd& field, int iterAmt) const {
+        assert(field.size() == vertAmt());
+
+        Eigen::VectorXd field_prev(field.size());
+        for(int iterI = 0; iterI < iterAmt; iterI++) {
+            field_prev.swap(field);
+            tbb::parallel_for(tbb::blocked_range<int>(0, vertAmt(), 1024), [&](const tbb::blocked_range<int>& range) {
+                for(int vI = range.begin(); vI != range.end(); vI++) {
+                    double sum = field_prev[vI];
+                    for(int edgeI = offset[vI]; edgeI < offset[vI + 1]; edgeI++) {
+                        sum += field_prev[adjacency[edgeI]];
+                    }
+                    field[vI] = sum / (offset[vI + 1] - offset[vI] + 1);
+                }
+            });
+        }
+    }
+
+    int MeshGraph::farthestVert(const std::vector<double>& dist) {
+        double maxDist = 0.0;
+        int vI_maxDist = -1;
+        for(int vI = 0; vI < dist.size(); vI++) {
+            if((dist[vI] > maxDist) && (dist[vI] != __DBL_MAX__)) {
+                maxDist = dist[vI];
+                vI_maxDist = vI;
+            }
+        }
+        return vI_maxDist;
+    }
+
+    void MeshGraph::tracePath(const std::vector<int>& parent, int vI, std::vector<int>& path) {
+        path.resize(0);
+        while(vI >= 0) {
+            path.emplace_back(vI);
+            vI = parent[vI];
+        }
+        std::reverse(path.begin(), path.end());
+    }
+
+}
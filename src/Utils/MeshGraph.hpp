@@ -0,0 +1,57 @@
+//
+//  MeshGraph.hpp
+//  OptCuts
+//
+
+#ifndef MeshGraph_hpp
+#define MeshGraph_hpp
+
+#include <Eigen/Eigen>
+
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace OptCuts {
+
+    // undirected edge-weighted graph in compressed sparse row form
+    // for the shortest path queries of the initial cuts and for smoothing vertex fields,
+    // queries use a binary heap and only read the graph, so they can run concurrently
+    class MeshGraph {
+    protected:
+        std::vector<int> offset; // neighbors of vI are at [offset[vI], offset[vI + 1])
+        std::vector<int> adjacency;
+        std::vector<double> weight;
+
+    public:
+        MeshGraph(void);
+        // vertices adjacent in vNeighbor are connected by edges of their Euclidean length in V
+        MeshGraph(const std::vector<std::set<int>>& vNeighbor, const Eigen::MatrixXd& V);
+
+        int vertAmt(void) const;
+
+        // distances to the closest source and the predecessors along the shortest paths,
+        // unreachable vertices keep __DBL_MAX__ and parent -1,
+        // with isTarget the search stops as soon as a target vertex is settled and returns it
+        // (-1 if none is reachable), the distances of unsettled vertices are then only upper bounds
+        int shortestPaths(const std::vector<int>& srcs, std::vector<double>& dist, std::vector<int>& parent,
+                          const std::function<bool(int)>& isTarget = std::function<bool(int)>()) const;
+
+        // one single-source query per source, run in parallel, each returns the
+        // reachable vertex with the largest distance (the lowest index among ties)
+        // and the shortest path from the source to it
+        void farthestPaths(const std::vector<int>& srcs, std::vector<std::vector<int>>& paths) const;
+
+        // iterAmt Jacobi steps each replacing a value by the average of itself and its neighbors,
+        // every step only reads the previous one so that the vertices are updated in parallel
+        void smoothField(Eigen::VectorXd& field, int iterAmt = 1) const;
+
+        // the reachable vertex of largest distance, -1 if there is none
+        static int farthestVert(const std::vector<double>& dist);
+        // path from the source to vI following parent
+        static void tracePath(const std::vector<int>& parent, int vI, std::vector<int>& path);
+    };
+
+}
+
+#endif /* MeshGraph_hpp */
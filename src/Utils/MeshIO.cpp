@@ -0,0 +1,599 @@
+//
+//  MeshIO.cpp
+//  OptCuts
+//
+
+#include "MeshIO.hpp"
+
+#include <tbb/tbb.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "MappedFile.hpp"
+
+namespace OptCuts {
+    namespace MeshIO {
+
+        namespace {
+            // chunk boundaries at line starts
+            std::vector<const char*> splitLines(const char* begin, const char* end)
+            {
+                const size_t chunkSize = 1 << 20;
+                const size_t chunkAmt = (end - begin) / chunkSize + 1;
+                std::vector<const char*> bounds(1, begin);
+                for(size_t chunkI = 1; chunkI < chunkAmt; chunkI++) {
+                    const char* p = std::max(begin + chunkI * chunkSize, bounds.back());
+                    p = static_cast<const char*>(memchr(p, '\n', end - p));
+                    if(!p) {
+                        break;
+                    }
+                    bounds.emplace_back(p + 1);
+                }
+                bounds.emplace_back(end);
+                return bounds;
+            }
+
+            inline bool isBlank(char c) { return (c == ' ') || (c == '\t') || (c == '\r'); }
+            inline bool isDigit(char c) { return (c >= '0') && (c <= '9'); }
+
+            inline const char* skipBlanks(const char* p, const char* end)
+            {
+                while((p < end) && isBlank(*p)) {
+                    p++;
+                }
+                return p;
+            }
+
+            inline const char* findLineEnd(const char* p, const char* end)
+            {
+                const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+                return lineEnd ? lineEnd : end;
+            }
+
+            inline const char* nextLine(const char* lineEnd, const char* end)
+            {
+                return (lineEnd < end) ? (lineEnd + 1) : end;
+            }
+
+            // fails on values outside [-INT_MAX, INT_MAX] after consuming all their digits,
+            // so that indices and element counts always fit in an int
+            bool parseInt(const char*& p, const char* end, long& val)
+            {
+                bool neg = false;
+                if((p < end) && ((*p == '-') || (*p == '+'))) {
+                    neg = (*p == '-');
+                    p++;
+                }
+                if((p >= end) || !isDigit(*p)) {
+                    return false;
+                }
+                val = 0;
+                bool overflow = false;
+                while((p < end) && isDigit(*p)) {
+                    const int digit = *p - '0';
+                    if(val > (INT_MAX - digit) / 10) {
+                        overflow = true;
+                    }
+                    else {
+                        val = val * 10 + digit;
+                    }
+                    p++;
+                }
+                if(neg) {
+                    val = -val;
+                }
+                return !overflow;
+            }
+
+            // exact with a single rounding when the decimal mantissa fits in 53 bits and
+            // the exponent is within the exactly representable powers of 10 (Clinger's fast path),
+            // falls back to strtod otherwise, so the result is always the same as strtod
+            bool parseDouble(const char*& p, const char* end, double& val)
+            {
+                static const double pow10[] = {
+                    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                };
+                const uint64_t mantissaLimit = (UINT64_MAX - 9) / 10;
+
+                const char* start = p;
+                bool neg = false;
+                if((p < end) && ((*p == '-') || (*p == '+'))) {
+                    neg = (*p == '-');
+                    p++;
+                }
+                uint64_t mantissa = 0;
+                int exp10 = 0;
+                bool anyDigit = false, truncated = false;
+                while((p < end) && isDigit(*p)) {
+                    if(mantissa <= mantissaLimit) {
+                        mantissa = mantissa * 10 + (*p - '0');
+                    }
+                    else {
+                        exp10++;
+                        truncated = true;
+                    }
+                    anyDigit = true;
+                    p++;
+                }
+                if((p < end) && (*p == '.')) {
+                    p++;
+                    while((p < end) && isDigit(*p)) {
+                        if(mantissa <= mantissaLimit) {
+                            mantissa = mantissa * 10 + (*p - '0');
+                            exp10--;
+                        }
+                        else {
+                            truncated = true;
+                        }
+                        anyDigit = true;
+                        p++;
+                    }
+                }
+                bool fastPath = anyDigit && !truncated;
+                if(fastPath && (p < end) && ((*p == 'e') || (*p == 'E'))) {
+                    p++;
+                    long exp10_explicit;
+                    if(parseInt(p, end, exp10_explicit) && (std::labs(exp10_explicit) < 1000)) {
+                        exp10 += static_cast<int>(exp10_explicit);
+                    }
+                    else {
+                        fastPath = false;
+                    }
+                }
+                if(fastPath && ((p >= end) || isBlank(*p) || (*p == '\n') || (*p == '/')) &&
+                   (mantissa <= (1ull << 53)) && (exp10 >= -22) && (exp10 <= 22))
+                {
+                    const double absVal = ((exp10 < 0) ? (mantissa / pow10[-exp10]) : (mantissa * pow10[exp10]));
+                    val = (neg ? -absVal : absVal);
+                    return true;
+                }
+
+                // the file is not null-terminated
+                char token[128];
+                size_t tokenLen = 0;
+                for(p = start; (p < end) && !isBlank(*p) && (*p != '\n'); p++) {
+                    if(tokenLen + 1 >= sizeof(token)) {
+                        return false;
+                    }
+                    token[tokenLen++] = *p;
+                }
+                token[tokenLen] = '\0';
+                char* tokenEnd;
+                val = std::strtod(token, &tokenEnd);
+                return (tokenEnd != token) && (tokenEnd == token + tokenLen);
+            }
+
+            // parses the first valAmt values of the line, the rest are optional if allowed
+            int parseDoubles(const char* p, const char* lineEnd, double* val, int valAmt)
+            {
+                int parsedAmt = 0;
+                for(; parsedAmt < valAmt; parsedAmt++) {
+                    p = skipBlanks(p, lineEnd);
+                    if((p >= lineEnd) || !parseDouble(p, lineEnd, val[parsedAmt])) {
+                        break;
+                    }
+                }
+                return parsedAmt;
+            }
+
+            enum OBJLineType { OBJ_OTHER, OBJ_V, OBJ_VT, OBJ_VN, OBJ_F };
+
+            // p is moved after the keyword
+            OBJLineType objLineType(const char*& p, const char* lineEnd)
+            {
+                p = skipBlanks(p, lineEnd);
+                if((p + 1 < lineEnd) && isBlank(p[1])) {
+                    if(p[0] == 'v') {
+                        p += 1;
+                        return OBJ_V;
+                    }
+                    if(p[0] == 'f') {
+                        p += 1;
+                        return OBJ_F;
+                    }
+                }
+                else if((p + 2 < lineEnd) && (p[0] == 'v') && isBlank(p[2])) {
+                    if(p[1] == 't') {
+                        p += 2;
+                        return OBJ_VT;
+                    }
+                    if(p[1] == 'n') {
+                        p += 2;
+                        return OBJ_VN;
+                    }
+                }
+                return OBJ_OTHER;
+            }
+
+            struct OBJCounts {
+                int v = 0, vt = 0, vn = 0, tri = 0;
+                bool allTC = true, allN = true;
+                bool valid = true;
+            };
+
+            // 1-based or negative relative index to 0-based, -1 if out of range
+            // range-checked before resolving so that no arithmetic can overflow
+            inline int resolveIndex(long ind, int curAmt)
+            {
+                if((ind == 0) || (ind > curAmt) || (ind < -static_cast<long>(curAmt))) {
+                    return -1;
+                }
+                return static_cast<int>((ind > 0) ? (ind - 1) : (curAmt + ind));
+            }
+        }
+
+        bool readOBJ(const std::string& filePath,
+                     Eigen::MatrixXd& V, Eigen::MatrixXd& TC, Eigen::MatrixXd& N,
+                     Eigen::MatrixXi& F, Eigen::MatrixXi& FTC, Eigen::MatrixXi& FN)
+        {
+            MappedFile file(filePath);
+            if(!file.isOpen()) {
+                std::cout << "failed to open " << filePath << std::endl;
+                return false;
+            }
+            const std::vector<const char*> bounds = splitLines(file.begin(), file.end());
+            const int chunkAmt = static_cast<int>(bounds.size()) - 1;
+
+            // count the elements in each chunk
+            std::vector<OBJCounts> counts(chunkAmt);
+            tbb::parallel_for(0, chunkAmt, 1, [&](int chunkI) {
+                OBJCounts& count = counts[chunkI];
+                for(const char* p = bounds[chunkI]; p < bounds[chunkI + 1]; ) {
+                    const char* lineEnd = findLineEnd(p, bounds[chunkI + 1]);
+                    switch(objLineType(p, lineEnd)) {
+                        case OBJ_V:
+                            count.v++;
+                            break;
+
+                        case OBJ_VT:
+                            count.vt++;
+                            break;
+
+                        case OBJ_VN:
+                            count.vn++;
+                            break;
+
+                        case OBJ_F: {
+                            int cornerAmt = 0;
+                            while((p = skipBlanks(p, lineEnd)) < lineEnd) {
+                                const char* tokenEnd = p;
+                                while((tokenEnd < lineEnd) && !isBlank(*tokenEnd)) {
+                                    tokenEnd++;
+                                }
+                                const char* slash = static_cast<const char*>(memchr(p, '/', tokenEnd - p));
+                                const char* slash2 = (slash ? static_cast<const char*>(memchr(slash + 1, '/', tokenEnd - slash - 1)) : NULL);
+                                count.allTC = count.allTC && slash && (slash + 1 < tokenEnd) && (slash[1] != '/');
+                                count.allN = count.allN && slash2 && (slash2 + 1 < tokenEnd);
+                                cornerAmt++;
+                                p = tokenEnd;
+                            }
+                            if(cornerAmt < 3) {
+                                count.valid = false;
+                            }
+                            count.tri += std::max(0, cornerAmt - 2);
+                            break;
+                        }
+
+                        default:
+                            break;
+                    }
+                    p = nextLine(lineEnd, bounds[chunkI + 1]);
+                }
+            });
+
+            OBJCounts total;
+            std::vector<OBJCounts> offsets(chunkAmt);
+            for(int chunkI = 0; chunkI < chunkAmt; chunkI++) {
+                offsets[chunkI] = total;
+                total.v += counts[chunkI].v;
+                total.vt += counts[chunkI].vt;
+                total.vn += counts[chunkI].vn;
+                total.tri += counts[chunkI].tri;
+                total.allTC = total.allTC && counts[chunkI].allTC;
+                total.allN = total.allN && counts[chunkI].allN;
+                total.valid = total.valid && counts[chunkI].valid;
+            }
+            if(!total.valid) {
+                std::cout << "faces with less than 3 vertices in " << filePath << std::endl;
+                return false;
+            }
+
+            V.resize(total.v, 3);
+            TC.resize(total.vt, 2);
+            N.resize(total.vn, 3);
+            F.resize(total.tri, 3);
+            FTC.resize(total.allTC ? total.tri : 0, 3);
+            FN.resize(total.allN ? total.tri : 0, 3);
+
+            // parse each chunk into its rows
+            std::atomic<bool> failed(false);
+            tbb::parallel_for(0, chunkAmt, 1, [&](int chunkI) {
+                OBJCounts cur = offsets[chunkI];
+                std::vector<int> polyV, polyTC, polyN;
+                double val[3];
+                for(const char* p = bounds[chunkI]; (p < bounds[chunkI + 1]) && !failed; ) {
+                    const char* lineEnd = findLineEnd(p, bounds[chunkI + 1]);
+                    switch(objLineType(p, lineEnd)) {
+                        case OBJ_V:
+                            if(parseDoubles(p, lineEnd, val, 3) < 3) {
+                                failed = true;
+                            }
+                            V.row(cur.v++) << val[0], val[1], val[2];
+                            break;
+
+                        case OBJ_VT:
+                            val[1] = 0.0;
+                            if(parseDoubles(p, lineEnd, val, 2) < 1) {
+                                failed = true;
+                            }
+                            TC.row(cur.vt++) << val[0], val[1];
+                            break;
+
+                        case OBJ_VN:
+                            if(parseDoubles(p, lineEnd, val, 3) < 3) {
+                                failed = true;
+                            }
+                            N.row(cur.vn++) << val[0], val[1], val[2];
+                            break;
+
+                        case OBJ_F: {
+                            polyV.resize(0);
+                            polyTC.resize(0);
+                            polyN.resize(0);
+                            while(((p = skipBlanks(p, lineEnd)) < lineEnd) && !failed) {
+                                long ind;
+                                if(!parseInt(p, lineEnd, ind)) {
+                                    failed = true;
+                                    break;
+                                }
+                                polyV.emplace_back(resolveIndex(ind, cur.v));
+                                // the texture coordinate index may be empty (v//vn), but not invalid
+                                if((p < lineEnd) && (*p == '/')) {
+                                    p++;
+                                    if((p < lineEnd) && (*p != '/') && !isBlank(*p)) {
+                                        if(!parseInt(p, lineEnd, ind)) {
+                                            failed = true;
+                                            break;
+                                        }
+                                        polyTC.emplace_back(resolveIndex(ind, cur.vt));
+                                    }
+                                    if((p < lineEnd) && (*p == '/')) {
+                                        p++;
+                                        if((p < lineEnd) && !isBlank(*p)) {
+                                            if(!parseInt(p, lineEnd, ind)) {
+                                                failed = true;
+                                                break;
+                                            }
+                                            polyN.emplace_back(resolveIndex(ind, cur.vn));
+                                        }
+                                    }
+                                }
+                                if((p < lineEnd) && !isBlank(*p)) {
+                                    failed = true;
+                                }
+                            }
+                            if(failed || (std::find(polyV.begin(), polyV.end(), -1) != polyV.end()) ||
+                               (FTC.rows() && ((polyTC.size() != polyV.size()) ||
+                                               (std::find(polyTC.begin(), polyTC.end(), -1) != polyTC.end()))) ||
+                               (FN.rows() && ((polyN.size() != polyV.size()) ||
+                                              (std::find(polyN.begin(), polyN.end(), -1) != polyN.end()))))
+                            {
+                                failed = true;
+                                break;
+                            }
+
+                            for(int cornerI = 1; cornerI + 1 < polyV.size(); cornerI++) {
+                                F.row(cur.tri) << polyV[0], polyV[cornerI], polyV[cornerI + 1];
+                                if(FTC.rows()) {
+                                    FTC.row(cur.tri) << polyTC[0], polyTC[cornerI], polyTC[cornerI + 1];
+                                }
+                                if(FN.rows()) {
+                                    FN.row(cur.tri) << polyN[0], polyN[cornerI], polyN[cornerI + 1];
+                                }
+                                cur.tri++;
+                            }
+                            break;
+                        }
+
+                        default:
+                            break;
+                    }
+                    p = nextLine(lineEnd, bounds[chunkI + 1]);
+                }
+            });
+            if(failed) {
+                std::cout << "failed to parse " << filePath << std::endl;
+                return false;
+            }
+
+            return true;
+        }
+
+        bool readOBJ(const std::string& filePath, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
+        {
+            Eigen::MatrixXd TC, N;
+            Eigen::MatrixXi FTC, FN;
+            return readOBJ(filePath, V, TC, N, F, FTC, FN);
+        }
+
+        bool readOFF(const std::string& filePath, Eigen::MatrixXd& V, Eigen::MatrixXi& F)
+        {
+            MappedFile file(filePath);
+            if(!file.isOpen()) {
+                std::cout << "failed to open " << filePath << std::endl;
+                return false;
+            }
+
+            // header, with comments allowed before the element counts
+            const char* p = file.begin();
+            long elemAmt[3] = {0, 0, 0};
+            int headerValAmt = -1; // the keyword is not found yet
+            while((p < file.end()) && (headerValAmt < 2)) {
+                const char* lineEnd = findLineEnd(p, file.end());
+                p = skipBlanks(p, lineEnd);
+                if((p < lineEnd) && (*p != '#')) {
+                    if(headerValAmt < 0) {
+                        const char* keywordEnd = p;
+                        while((keywordEnd < lineEnd) && !isBlank(*keywordEnd)) {
+                            keywordEnd++;
+                        }
+                        if((keywordEnd - p < 3) || strncmp(keywordEnd - 3, "OFF", 3)) {
+                            std::cout << filePath << " is not an OFF file" << std::endl;
+                            return false;
+                        }
+                        headerValAmt = 0;
+                        p = keywordEnd;
+                    }
+                    while((headerValAmt < 3) && ((p = skipBlanks(p, lineEnd)) < lineEnd) &&
+                          parseInt(p, lineEnd, elemAmt[headerValAmt]))
+                    {
+                        headerValAmt++;
+                    }
+                }
+                p = nextLine(lineEnd, file.end());
+            }
+            if((headerValAmt < 2) || (elemAmt[0] < 0) || (elemAmt[1] < 0)) {
+                std::cout << "invalid OFF header in " << filePath << std::endl;
+                return false;
+            }
+            const int vertAmt = static_cast<int>(elemAmt[0]), faceAmt = static_cast<int>(elemAmt[1]);
+            const char* bodyBegin = p;
+
+            // data lines are vertices first and then faces, so each chunk needs its first line index
+            const std::vector<const char*> bounds = splitLines(bodyBegin, file.end());
+            const int chunkAmt = static_cast<int>(bounds.size()) - 1;
+            std::vector<int> lineStart(chunkAmt + 1, 0);
+            tbb::parallel_for(0, chunkAmt, 1, [&](int chunkI) {
+                for(const char* p = bounds[chunkI]; p < bounds[chunkI + 1]; ) {
+                    const char* lineEnd = findLineEnd(p, bounds[chunkI + 1]);
+                    p = skipBlanks(p, lineEnd);
+                    if((p < lineEnd) && (*p != '#')) {
+                        lineStart[chunkI + 1]++;
+                    }
+                    p = nextLine(lineEnd, bounds[chunkI + 1]);
+                }
+            });
+            for(int chunkI = 0; chunkI < chunkAmt; chunkI++) {
+                lineStart[chunkI + 1] += lineStart[chunkI];
+            }
+            if(lineStart.back() < vertAmt + faceAmt) {
+                std::cout << "missing elements in " << filePath << std::endl;
+                return false;
+            }
+
+            // faces are triangulated per chunk and then concatenated in order
+            V.resize(vertAmt, 3);
+            std::vector<std::vector<int>> tris(chunkAmt);
+            std::atomic<bool> failed(false);
+            tbb::parallel_for(0, chunkAmt, 1, [&](int chunkI) {
+                int lineI = lineStart[chunkI];
+                double val[3];
+                std::vector<long> poly;
+                for(const char* p = bounds[chunkI]; (p < bounds[chunkI + 1]) && !failed; ) {
+                    const char* lineEnd = findLineEnd(p, bounds[chunkI + 1]);
+                    p = skipBlanks(p, lineEnd);
+                    if((p < lineEnd) && (*p != '#')) {
+                        if(lineI < vertAmt) {
+                            if(parseDoubles(p, lineEnd, val, 3) < 3) {
+                                failed = true;
+                            }
+                            V.row(lineI) << val[0], val[1], val[2];
+                        }
+                        else if(lineI < vertAmt + faceAmt) {
+                            long cornerAmt;
+                            if(!parseInt(p, lineEnd, cornerAmt) || (cornerAmt < 3)) {
+                                failed = true;
+                                break;
+                            }
+                            poly.resize(cornerAmt);
+                            for(auto& vI : poly) {
+                                p = skipBlanks(p, lineEnd);
+                                if(!parseInt(p, lineEnd, vI) || (vI < 0) || (vI >= vertAmt)) {
+                                    failed = true;
+                                    break;
+                                }
+                            }
+                            for(int cornerI = 1; (cornerI + 1 < cornerAmt) && !failed; cornerI++) {
+                                tris[chunkI].emplace_back(poly[0]);
+                                tris[chunkI].emplace_back(poly[cornerI]);
+                                tris[chunkI].emplace_back(poly[cornerI + 1]);
+                            }
+                        }
+                        lineI++;
+                    }
+                    p = nextLine(lineEnd, bounds[chunkI + 1]);
+                }
+            });
+            if(failed) {
+                std::cout << "failed to parse " << filePath << std::endl;
+                return false;
+            }
+
+            int triAmt = 0;
+            for(const auto& trisI : tris) {
+                triAmt += static_cast<int>(trisI.size()) / 3;
+            }
+            F.resize(triAmt, 3);
+            int triI = 0;
+            for(const auto& trisI : tris) {
+                for(int i = 0; i < trisI.size(); i += 3) {
+                    F.row(triI++) << trisI[i], trisI[i + 1], trisI[i + 2];
+                }
+            }
+
+            return true;
+        }
+
+        bool readSelection(const std::string& filePath, int vertAmt, std::vector<char>& selected)
+        {
+            MappedFile file(filePath);
+            if(!file.isOpen()) {
+                std::cout << "failed to open " << filePath << std::endl;
+                return false;
+            }
+
+            // the indices of each chunk are marked afterwards so that no entry is written concurrently
+            const std::vector<const char*> bounds = splitLines(file.begin(), file.end());
+            const int chunkAmt = static_cast<int>(bounds.size()) - 1;
+            std::vector<std::vector<int>> inds(chunkAmt);
+            std::atomic<bool> failed(false);
+            tbb::parallel_for(0, chunkAmt, 1, [&](int chunkI) {
+                for(const char* p = bounds[chunkI]; (p < bounds[chunkI + 1]) && !failed; ) {
+                    const char* lineEnd = findLineEnd(p, bounds[chunkI + 1]);
+                    while((p = skipBlanks(p, lineEnd)) < lineEnd) {
+                        long ind;
+                        if(!parseInt(p, lineEnd, ind) || ((p < lineEnd) && !isBlank(*p))) {
+                            failed = true;
+                            break;
+                        }
+                        if((ind >= 0) && (ind < vertAmt)) {
+                            inds[chunkI].emplace_back(static_cast<int>(ind));
+                        }
+                    }
+                    p = nextLine(lineEnd, bounds[chunkI + 1]);
+                }
+            });
+            if(failed) {
+                std::cout << "failed to parse " << filePath << std::endl;
+                return false;
+            }
+
+            selected.assign(vertAmt, 0);
+            for(const auto& indsI : inds) {
+                for(const auto& vI : indsI) {
+                    selected[vI] = 1;
+                }
+            }
+            return true;
+        }
+
+    }
+}
@@ -0,0 +1,39 @@
+//
+//  MeshIO.hpp
+//  OptCuts
+//
+
+#ifndef MeshIO_hpp
+#define MeshIO_hpp
+
+#include <Eigen/Eigen>
+
+#include <string>
+#include <vector>
+
+namespace OptCuts {
+
+    // drop-in replacements of igl::readOBJ and igl::readOFF for large meshes:
+    // the file is memory-mapped, split into chunks at line boundaries,
+    // counted and then parsed in parallel directly into the output matrices,
+    // polygons are triangulated as fans, texture coordinates and normals have 2 and 3 columns,
+    // FTC and FN are empty unless every face has them
+    namespace MeshIO {
+
+        bool readOBJ(const std::string& filePath,
+                     Eigen::MatrixXd& V, Eigen::MatrixXd& TC, Eigen::MatrixXd& N,
+                     Eigen::MatrixXi& F, Eigen::MatrixXi& FTC, Eigen::MatrixXi& FN);
+        bool readOBJ(const std::string& filePath, Eigen::MatrixXd& V, Eigen::MatrixXi& F);
+
+        bool readOFF(const std::string& filePath, Eigen::MatrixXd& V, Eigen::MatrixXi& F);
+
+        // whitespace-separated vertex indices, selected gets one entry per vertex,
+        // indices outside [0, vertAmt) are ignored and ones that do not fit in an int reject the file,
+        // see BinaryMesh::readSelection() for the binary form of large selections
+        bool readSelection(const std::string& filePath, int vertAmt, std::vector<char>& selected);
+
+    }
+
+}
+
+#endif /* MeshIO_hpp */
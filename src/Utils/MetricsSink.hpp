@@ -0,0 +1,96 @@
+//
+//  MetricsSink.hpp
+//  OptCuts
+//
+
+#ifndef MetricsSink_hpp
+#define MetricsSink_hpp
+
+#include "AsyncFileWriter.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace OptCuts {
+
+    // a flat JSON object written as one line of a JSON Lines file,
+    // non-finite numbers are written as null
+    class MetricsRecord {
+    protected:
+        std::ostringstream buffer;
+
+    public:
+        explicit MetricsRecord(const std::string& type) {
+            buffer << std::setprecision(10) << "{\"type\":\"" << type << "\"";
+        }
+
+        MetricsRecord& add(const char* key, double val) {
+            buffer << ",\"" << key << "\":";
+            writeNumber(val);
+            return *this;
+        }
+        MetricsRecord& add(const char* key, int val) {
+            buffer << ",\"" << key << "\":" << val;
+            return *this;
+        }
+        MetricsRecord& add(const char* key, bool val) {
+            buffer << ",\"" << key << "\":" << (val ? "true" : "false");
+            return *this;
+        }
+        // keys and string values are not escaped, only pass plain identifiers
+        MetricsRecord& add(const char* key, const char* val) {
+            buffer << ",\"" << key << "\":\"" << val << "\"";
+            return *this;
+        }
+        MetricsRecord& add(const char* key, const std::vector<int>& vals) {
+            buffer << ",\"" << key << "\":[";
+            for(int valI = 0; valI < vals.size(); valI++) {
+                buffer << (valI ? "," : "") << vals[valI];
+            }
+            buffer << "]";
+            return *this;
+        }
+        MetricsRecord& add(const char* key, const std::vector<double>& vals) {
+            buffer << ",\"" << key << "\":[";
+            for(int valI = 0; valI < vals.size(); valI++) {
+                if(valI) {
+                    buffer << ",";
+                }
+                writeNumber(vals[valI]);
+            }
+            buffer << "]";
+            return *this;
+        }
+
+        std::string line(void) const { return buffer.str() + "}\n"; }
+
+    protected:
+        void writeNumber(double val) {
+            if(std::isfinite(val)) {
+                buffer << val;
+            }
+            else {
+                buffer << "null";
+            }
+        }
+    };
+
+    // per-iteration records of the optimization for ingestion by scripts,
+    // records are only formatted by the caller and written asynchronously
+    class MetricsSink {
+    protected:
+        AsyncFileWriter writer;
+
+    public:
+        bool open(const std::string& filePath, bool append = false) { return writer.open(filePath, false, append); }
+        bool isOpen(void) const { return writer.isOpen(); }
+        void emit(const MetricsRecord& record) { writer.write(record.line()); }
+        void close(void) { writer.close(); }
+    };
+
+}
+
+#endif /* MetricsSink_hpp */
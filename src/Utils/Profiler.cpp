@@ -0,0 +1,328 @@
+//
+//  Profiler.cpp
+//  OptCuts
+//
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+
+namespace OptCuts {
+
+    Profiler profiler;
+
+    namespace {
+        // nearest-rank percentile of sorted values
+        double percentile(const std::vector<double>& sorted, double p) {
+            assert(!sorted.empty());
+            const int rank = static_cast<int>(std::ceil(p * sorted.size())) - 1;
+            return sorted[std::max(0, std::min(rank, static_cast<int>(sorted.size()) - 1))];
+        }
+
+        void writeStats(std::ofstream& file, std::vector<double>& durations) {
+            std::sort(durations.begin(), durations.end());
+            double total = 0.0;
+            for(const auto& durI : durations) {
+                total += durI;
+            }
+            file << " count " << durations.size() << " total " << total << " mean " << total / durations.size()
+                << " p50 " << percentile(durations, 0.5) << " p90 " << percentile(durations, 0.9)
+                << " p99 " << percentile(durations, 0.99) << " max " << durations.back() << std::endl;
+        }
+
+        // in nanoseconds, the inverse of Profiler::durationBin()
+        double binCenter(int binI) {
+            if(binI < 8) {
+                return binI;
+            }
+            const double width = std::ldexp(1.0, binI / 8 - 1);
+            return (8 + binI % 8) * width + 0.5 * width;
+        }
+
+        // nearest-rank percentile in milliseconds from the histogram of a node,
+        // within half a bin (6%) of the exact one
+        double percentile(const std::vector<int64_t>& histogram, int64_t count, int64_t max, double p) {
+            const int64_t rank = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(p * count)));
+            int64_t countSum = 0;
+            for(int binI = 0; binI < histogram.size(); binI++) {
+                countSum += histogram[binI];
+                if(countSum >= rank) {
+                    return std::min(binCenter(binI), static_cast<double>(max)) * 1.0e-6;
+                }
+            }
+            return max * 1.0e-6;
+        }
+
+        void writeStats(std::ofstream& file, const std::vector<int64_t>& histogram, int64_t count, int64_t total, int64_t max) {
+            file << " count " << count << " total " << total * 1.0e-6 << " mean " << total * 1.0e-6 / count
+                << " p50 " << percentile(histogram, count, max, 0.5) << " p90 " << percentile(histogram, count, max, 0.9)
+                << " p99 " << percentile(histogram, count, max, 0.99) << " max " << max * 1.0e-6 << std::endl;
+        }
+
+        // counts of durations in [2^i, 2^(i+1)) microseconds, shorter ones are in the first bin,
+        // assigned by the centers of the finer bins
+        void writeHistogram(std::ofstream& file, const std::vector<int64_t>& histogram) {
+            std::map<int, int64_t> bins;
+            for(int binI = 0; binI < histogram.size(); binI++) {
+                if(histogram[binI] > 0) {
+                    const double us = binCenter(binI) * 1.0e-3;
+                    bins[(us < 1.0) ? 0 : static_cast<int>(std::log2(us))] += histogram[binI];
+                }
+            }
+            file << "    histogram(us)";
+            for(const auto& binI : bins) {
+                file << " " << (1ll << binI.first) << ":" << binI.second;
+            }
+            file << std::endl;
+        }
+
+        std::string escapeJSON(const std::string& str) {
+            std::string escaped;
+            for(const auto& charI : str) {
+                if((charI == '"') || (charI == '\\')) {
+                    escaped += '\\';
+                }
+                escaped += charI;
+            }
+            return escaped;
+        }
+    }
+
+    Profiler::Profiler(void) :
+        enabled(false), claimed(false), origin(std::chrono::steady_clock::now()), eventCapacity(65536) {}
+
+    void Profiler::setEnabled(bool p_enabled) {
+        enabled.store(p_enabled, std::memory_order_relaxed);
+    }
+
+    bool Profiler::claim(void) {
+        bool expected = false;
+        if(!claimed.compare_exchange_strong(expected, true)) {
+            return false;
+        }
+        reset();
+        setEnabled(true);
+        return true;
+    }
+
+    void Profiler::release(void) {
+        setEnabled(false);
+        reset();
+        claimed.store(false);
+    }
+
+    void Profiler::reset(void) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(const auto& bufferI : threadBuffers) {
+            // the call tree is kept for the zones that are still open
+            std::lock_guard<std::mutex> bufferLock(bufferI->mutex);
+            bufferI->events.clear();
+            bufferI->recordedAmt = 0;
+            for(auto& nodeI : bufferI->nodes) {
+                nodeI.count = nodeI.total = nodeI.max = 0;
+                std::fill(nodeI.histogram.begin(), nodeI.histogram.end(), 0);
+            }
+        }
+    }
+
+    int Profiler::registerZone(const std::string& name, bool isFrame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(int zoneI = 0; zoneI < zoneNames.size(); zoneI++) {
+            if(zoneNames[zoneI] == name) {
+                zoneIsFrame[zoneI] = zoneIsFrame[zoneI] || isFrame;
+                return zoneI;
+            }
+        }
+        zoneNames.emplace_back(name);
+        zoneIsFrame.push_back(isFrame);
+        return static_cast<int>(zoneNames.size()) - 1;
+    }
+
+    Profiler::ThreadBuffer& Profiler::threadBuffer(void) {
+        // the buffer of the calling thread, owned by the profiler
+        thread_local ThreadBuffer* curThreadBuffer = NULL;
+        if(!curThreadBuffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threadBuffers.emplace_back(new ThreadBuffer);
+            threadBuffers.back()->tid = static_cast<int>(threadBuffers.size()) - 1;
+            threadBuffers.back()->events.reserve(std::min<size_t>(1024, eventCapacity));
+            threadBuffers.back()->recordedAmt = 0;
+            curThreadBuffer = threadBuffers.back().get();
+        }
+        return *curThreadBuffer;
+    }
+
+    int64_t Profiler::now(void) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    std::vector<Profiler::ThreadRecord> Profiler::threadRecords(void) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<ThreadRecord> records;
+        records.reserve(threadBuffers.size());
+        for(const auto& bufferI : threadBuffers) {
+            std::lock_guard<std::mutex> bufferLock(bufferI->mutex);
+            records.emplace_back(*bufferI);
+        }
+        return records;
+    }
+
+    std::string Profiler::nodePath(const ThreadRecord& record, int nodeI) const {
+        std::string path = zoneNames[record.nodes[nodeI].zoneI];
+        for(int parentNodeI = record.nodes[nodeI].parentNodeI; parentNodeI >= 0;
+            parentNodeI = record.nodes[parentNodeI].parentNodeI)
+        {
+            path = zoneNames[record.nodes[parentNodeI].zoneI] + "/" + path;
+        }
+        return path;
+    }
+
+    void Profiler::writeSummary(const std::string& filePath) const {
+        const std::vector<ThreadRecord> records = threadRecords();
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::ofstream file(filePath);
+        if(!file.is_open()) {
+            return;
+        }
+        file << std::fixed << std::setprecision(3);
+        file << "# all times in ms" << std::endl;
+
+        // call tree, per thread as tbb tasks have no enclosing zone on worker threads
+        file << "## call tree" << std::endl;
+        std::vector<std::vector<int64_t>> histogram_zone(zoneNames.size(), std::vector<int64_t>(histogramBinAmt, 0));
+        std::vector<int64_t> count_zone(zoneNames.size(), 0), total_zone(zoneNames.size(), 0), max_zone(zoneNames.size(), 0);
+        int64_t droppedAmt = 0;
+        for(const auto& recordI : records) {
+            std::map<std::string, int> nodeIByPath;
+            for(int nodeI = 0; nodeI < recordI.nodes.size(); nodeI++) {
+                const Node& node = recordI.nodes[nodeI];
+                nodeIByPath[nodePath(recordI, nodeI)] = nodeI;
+                count_zone[node.zoneI] += node.count;
+                total_zone[node.zoneI] += node.total;
+                max_zone[node.zoneI] = std::max(max_zone[node.zoneI], node.max);
+                for(int binI = 0; binI < histogramBinAmt; binI++) {
+                    histogram_zone[node.zoneI][binI] += node.histogram[binI];
+                }
+            }
+            droppedAmt += recordI.recordedAmt - static_cast<int64_t>(recordI.events.size());
+            file << "thread " << recordI.tid << std::endl;
+            for(const auto& pathI : nodeIByPath) {
+                const Node& node = recordI.nodes[pathI.second];
+                if(node.count == 0) {
+                    continue;
+                }
+                file << "  " << pathI.first;
+                writeStats(file, node.histogram, node.count, node.total, node.max);
+            }
+        }
+
+        // every zone over all threads and call paths
+        file << "## zones" << std::endl;
+        for(int zoneI = 0; zoneI < zoneNames.size(); zoneI++) {
+            if(count_zone[zoneI] == 0) {
+                continue;
+            }
+            file << "  " << zoneNames[zoneI];
+            writeStats(file, histogram_zone[zoneI], count_zone[zoneI], total_zone[zoneI], max_zone[zoneI]);
+            writeHistogram(file, histogram_zone[zoneI]);
+        }
+
+        // time spent per frame in each zone that started within it, on any thread,
+        // from the events that are still kept
+        if(droppedAmt > 0) {
+            file << "# per-frame statistics below only cover the latest " << eventCapacity
+                << " events per thread, " << droppedAmt << " earlier events were dropped" << std::endl;
+        }
+        for(int frameZoneI = 0; frameZoneI < zoneNames.size(); frameZoneI++) {
+            if(!zoneIsFrame[frameZoneI]) {
+                continue;
+            }
+
+            std::vector<std::pair<int64_t, int64_t>> frames;
+            for(const auto& recordI : records) {
+                for(const auto& eventI : recordI.events) {
+                    if(recordI.nodes[eventI.nodeI].zoneI == frameZoneI) {
+                        frames.emplace_back(eventI.start, eventI.end);
+                    }
+                }
+            }
+            if(frames.empty()) {
+                continue;
+            }
+            std::sort(frames.begin(), frames.end());
+
+            std::vector<std::vector<double>> durations_perFrame(zoneNames.size(), std::vector<double>(frames.size(), 0.0));
+            for(const auto& recordI : records) {
+                for(const auto& eventI : recordI.events) {
+                    const int zoneI = recordI.nodes[eventI.nodeI].zoneI;
+                    auto frameIter = std::upper_bound(frames.begin(), frames.end(),
+                                                      std::make_pair(eventI.start, std::numeric_limits<int64_t>::max()));
+                    if((zoneI == frameZoneI) || (frameIter == frames.begin())) {
+                        continue;
+                    }
+                    frameIter--;
+                    if(eventI.start < frameIter->second) {
+                        durations_perFrame[zoneI][frameIter - frames.begin()] += (eventI.end - eventI.start) * 1.0e-6;
+                    }
+                }
+            }
+
+            file << "## per " << zoneNames[frameZoneI] << " (" << frames.size() << " frames)" << std::endl;
+            std::vector<double> frameDurations;
+            for(const auto& frameI : frames) {
+                frameDurations.push_back((frameI.second - frameI.first) * 1.0e-6);
+            }
+            file << "  " << zoneNames[frameZoneI];
+            writeStats(file, frameDurations);
+            for(int zoneI = 0; zoneI < zoneNames.size(); zoneI++) {
+                if(std::find_if(durations_perFrame[zoneI].begin(), durations_perFrame[zoneI].end(),
+                                [](double dur) { return dur > 0.0; }) == durations_perFrame[zoneI].end())
+                {
+                    continue;
+                }
+                file << "  " << zoneNames[zoneI];
+                writeStats(file, durations_perFrame[zoneI]);
+            }
+        }
+
+        file.close();
+    }
+
+    void Profiler::writeChromeTrace(const std::string& filePath) const {
+        const std::vector<ThreadRecord> records = threadRecords();
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::ofstream file(filePath);
+        if(!file.is_open()) {
+            return;
+        }
+        file << std::fixed << std::setprecision(3);
+        // only the latest eventCapacity events of each thread are kept
+        int64_t droppedAmt = 0;
+        for(const auto& recordI : records) {
+            droppedAmt += recordI.recordedAmt - static_cast<int64_t>(recordI.events.size());
+        }
+        file << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":\"" << droppedAmt << "\"},\"traceEvents\":[";
+        bool first = true;
+        for(const auto& recordI : records) {
+            file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << recordI.tid
+                << ",\"args\":{\"name\":\"thread " << recordI.tid << "\"}}";
+            first = false;
+            for(const auto& eventI : recordI.events) {
+                file << ",\n{\"name\":\"" << escapeJSON(zoneNames[recordI.nodes[eventI.nodeI].zoneI])
+                    << "\",\"cat\":\"OptCuts\",\"ph\":\"X\",\"pid\":0,\"tid\":" << recordI.tid
+                    << ",\"ts\":" << eventI.start * 1.0e-3 << ",\"dur\":" << (eventI.end - eventI.start) * 1.0e-3 << "}";
+            }
+        }
+        file << "\n]}" << std::endl;
+        file.close();
+    }
+
+}
@@ -0,0 +1,206 @@
+//
+//  Profiler.hpp
+//  OptCuts
+//
+
+#ifndef Profiler_hpp
+#define Profiler_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// scoped, hierarchical zone profiler that is safe to use inside tbb tasks:
+//
+//     OPTCUTS_PROFILE_ZONE("backSolve");                  // until the end of the scope
+//     OPTCUTS_PROFILE_NAMED_ZONE(zone, "newtonIteration", true); // a frame zone,
+//     ...                                                  // can also be closed by zone.end()
+//
+// each thread records into its own buffer under a lock only the readers contend for,
+// nesting is tracked per thread,
+// frame zones (Newton iterations, topology steps) group everything that starts
+// within them, on any thread, for the per-frame percentiles in the summary,
+// memory is bounded: every call path keeps exact counts, totals and maxima and a
+// histogram for the percentiles, while only the latest events of each thread are
+// kept for the trace and the per-frame statistics,
+// when disabled a zone costs one relaxed atomic load,
+// one owner at a time claims the profiler, zones of all threads are recorded while it is enabled,
+// define OPTCUTS_NO_PROFILER to compile the zones out entirely
+
+#define OPTCUTS_PROFILE_CAT_IMPL(a, b) a##b
+#define OPTCUTS_PROFILE_CAT(a, b) OPTCUTS_PROFILE_CAT_IMPL(a, b)
+
+#ifdef OPTCUTS_NO_PROFILER
+#define OPTCUTS_PROFILE_NAMED_ZONE(var, name, isFrame) OptCuts::ProfileZone var
+#else
+#define OPTCUTS_PROFILE_NAMED_ZONE(var, name, isFrame) \
+    static const int OPTCUTS_PROFILE_CAT(var, _zoneID) = OptCuts::profiler.registerZone(name, isFrame); \
+    OptCuts::ProfileZone var(OPTCUTS_PROFILE_CAT(var, _zoneID))
+#endif
+#define OPTCUTS_PROFILE_ZONE(name) OPTCUTS_PROFILE_NAMED_ZONE(OPTCUTS_PROFILE_CAT(profileZone_, __LINE__), name, false)
+
+namespace OptCuts {
+
+    class Profiler {
+        friend class ProfileZone;
+
+    protected:
+        struct Event {
+            int nodeI; // node in the call tree of the recording thread
+            int64_t start, end; // nanoseconds since the origin
+        };
+
+        // 8 bins per octave of nanoseconds, durations below 8 ns have a bin each
+        static const int histogramBinAmt = 8 * 62;
+
+        struct Node {
+            int zoneI;
+            int parentNodeI; // -1 for zones opened with no enclosing zone on the thread
+            // over all its events, also the ones no longer kept
+            int64_t count, total, max; // total and max in nanoseconds
+            std::vector<int64_t> histogram; // counts per durationBin()
+        };
+
+        struct ThreadRecord {
+            int tid;
+            std::vector<Event> events; // a ring of the latest eventCapacity events
+            int64_t recordedAmt; // events recorded, the ones beyond eventCapacity overwrote the oldest
+            std::vector<Node> nodes;
+        };
+
+        struct ThreadBuffer : public ThreadRecord {
+            std::vector<int> openNodes; // stack of the currently open zones, only touched by its thread
+            std::mutex mutex; // guards writes of the recording thread and reads of the others
+        };
+
+        std::atomic<bool> enabled;
+        std::atomic<bool> claimed;
+        std::chrono::steady_clock::time_point origin;
+        size_t eventCapacity; // per thread
+
+        mutable std::mutex mutex; // guards the registries below, not the recording
+        std::vector<std::string> zoneNames;
+        std::vector<bool> zoneIsFrame;
+        std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+
+    public:
+        Profiler(void);
+
+        void setEnabled(bool p_enabled);
+        bool isEnabled(void) const { return enabled.load(std::memory_order_relaxed); }
+        // how many of the latest events each thread keeps (24 bytes each), default 65536,
+        // set before enabling
+        void setEventCapacity(size_t p_eventCapacity) { eventCapacity = p_eventCapacity; }
+
+        // claim the profiler and start recording from a reset state,
+        // returns false if another owner holds it
+        bool claim(void);
+        // stop recording, drop what was recorded and give up the claim
+        void release(void);
+        // drop all statistics and events, zones still open are recorded when they end
+        void reset(void);
+
+        // called once per zone site through the static in OPTCUTS_PROFILE_NAMED_ZONE,
+        // zones with the same name share statistics
+        int registerZone(const std::string& name, bool isFrame = false);
+
+        // hierarchical inclusive times, per-zone histograms and percentiles,
+        // and per-frame percentiles for each frame zone,
+        // zones still open are not included
+        void writeSummary(const std::string& filePath) const;
+        // Chrome trace event format, load with chrome://tracing or Perfetto
+        void writeChromeTrace(const std::string& filePath) const;
+
+    protected:
+        ThreadBuffer& threadBuffer(void);
+        int64_t now(void) const;
+        static int durationBin(int64_t duration) {
+            if(duration < 8) {
+                return static_cast<int>(std::max<int64_t>(duration, 0));
+            }
+            int exponent;
+            const double mantissa = std::frexp(static_cast<double>(duration), &exponent); // in [0.5, 1)
+            return std::min(histogramBinAmt - 1, 8 * (exponent - 3) + static_cast<int>((mantissa - 0.5) * 16.0));
+        }
+        void record(ThreadBuffer& buffer, int nodeI, int64_t start, int64_t end) {
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            Node& node = buffer.nodes[nodeI];
+            const int64_t duration = end - start;
+            node.count++;
+            node.total += duration;
+            node.max = std::max(node.max, duration);
+            node.histogram[durationBin(duration)]++;
+            if(buffer.events.size() < eventCapacity) {
+                buffer.events.push_back(Event{nodeI, start, end});
+            }
+            else if(eventCapacity > 0) {
+                buffer.events[buffer.recordedAmt % eventCapacity] = Event{nodeI, start, end};
+            }
+            buffer.recordedAmt++;
+        }
+        // copies of the thread buffers, each taken under its lock
+        std::vector<ThreadRecord> threadRecords(void) const;
+        std::string nodePath(const ThreadRecord& record, int nodeI) const;
+    };
+
+    extern Profiler profiler;
+
+#ifdef OPTCUTS_NO_PROFILER
+    class ProfileZone {
+    public:
+        void end(void) {}
+    };
+#else
+    class ProfileZone {
+    protected:
+        Profiler::ThreadBuffer* buffer; // NULL if the profiler was disabled when opened
+        int64_t start;
+
+    public:
+        explicit ProfileZone(int zoneI) : buffer(NULL) {
+            if(!profiler.isEnabled()) {
+                return;
+            }
+
+            buffer = &profiler.threadBuffer();
+            const int parentNodeI = (buffer->openNodes.empty() ? -1 : buffer->openNodes.back());
+            int nodeI = static_cast<int>(buffer->nodes.size()) - 1;
+            // the call tree is small, a linear search for the child is enough
+            while((nodeI >= 0) && ((buffer->nodes[nodeI].zoneI != zoneI) ||
+                                   (buffer->nodes[nodeI].parentNodeI != parentNodeI))) {
+                nodeI--;
+            }
+            if(nodeI < 0) {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                nodeI = static_cast<int>(buffer->nodes.size());
+                buffer->nodes.push_back(Profiler::Node{zoneI, parentNodeI, 0, 0, 0,
+                                                       std::vector<int64_t>(Profiler::histogramBinAmt, 0)});
+            }
+            buffer->openNodes.push_back(nodeI);
+            start = profiler.now();
+        }
+
+        ~ProfileZone(void) { end(); }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+        void end(void) {
+            if(buffer) {
+                profiler.record(*buffer, buffer->openNodes.back(), start, profiler.now());
+                buffer->openNodes.pop_back();
+                buffer = NULL;
+            }
+        }
+    };
+#endif
+
+}
+
+#endif /* Profiler_hpp */
@@ -105,6 +105,14 @@ public:
         }
     };
     
+    // Add a duration measured elsewhere (e.g. inside a concurrent task,
+    // where start/stop cannot be used) to the specified activity
+    void add(TimerInt activity, double seconds) {
+        if (activity >= 0 && activity < timings_.size()) {
+            timings_[activity] += seconds;
+        }
+    }
+    
     // Set the timing for a specific activity back to zero
     void reset(TimerInt activity) {
         if (activity >= 0 && activity < timings_.size()) {
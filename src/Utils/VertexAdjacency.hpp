@@ -0,0 +1,86 @@
+//
+//  VertexAdjacency.hpp
+//  OptCuts
+//
+
+#ifndef VertexAdjacency_hpp
+#define VertexAdjacency_hpp
+
+#include <cassert>
+#include <set>
+#include <vector>
+
+namespace OptCuts {
+
+    // vertex adjacency in compressed sparse row form with the neighbors of each vertex
+    // in ascending order (that of std::set), for the traversals of whole meshes
+    // (solver patterns, scaffold merging) where the per-vertex sets that the topology
+    // operations edit would be walked node by node,
+    // built in one pass, rows cannot be edited afterwards
+    class VertexAdjacency {
+    public:
+        class Row {
+        protected:
+            const int* rowBegin;
+            const int* rowEnd;
+
+        public:
+            Row(const int* p_begin, const int* p_end) : rowBegin(p_begin), rowEnd(p_end) {}
+
+            const int* begin(void) const { return rowBegin; }
+            const int* end(void) const { return rowEnd; }
+            int size(void) const { return static_cast<int>(rowEnd - rowBegin); }
+            bool empty(void) const { return rowBegin == rowEnd; }
+        };
+
+    protected:
+        std::vector<int> offset; // neighbors of vI are at [offset[vI], offset[vI + 1])
+        std::vector<int> adjacency;
+
+    public:
+        VertexAdjacency(void) : offset(1, 0) {}
+
+        // the storage is reused when rebuilding
+        void build(const std::vector<std::set<int>>& vNeighbor)
+        {
+            offset.resize(vNeighbor.size() + 1);
+            offset[0] = 0;
+            for(int vI = 0; vI < vNeighbor.size(); vI++) {
+                offset[vI + 1] = offset[vI] + static_cast<int>(vNeighbor[vI].size());
+            }
+            adjacency.resize(offset.back());
+            int* nb = adjacency.data();
+            for(const auto& neighborsI : vNeighbor) {
+                for(const auto& nbVI : neighborsI) {
+                    *nb++ = nbVI;
+                }
+            }
+        }
+
+        // row by row construction: reset(), then per vertex in order push_back() of its
+        // neighbors in ascending order followed by endRow()
+        void reset(int reservedNNZ = 0)
+        {
+            offset.resize(1);
+            adjacency.resize(0);
+            adjacency.reserve(reservedNNZ);
+        }
+        void push_back(int nbVI)
+        {
+            assert((adjacency.size() == offset.back()) || (adjacency.back() < nbVI));
+            adjacency.push_back(nbVI);
+        }
+        void endRow(void) { offset.push_back(static_cast<int>(adjacency.size())); }
+
+        int size(void) const { return static_cast<int>(offset.size()) - 1; }
+        int nnz(void) const { return static_cast<int>(adjacency.size()); }
+        Row operator[](int vI) const
+        {
+            assert((vI >= 0) && (vI < size()));
+            return Row(adjacency.data() + offset[vI], adjacency.data() + offset[vI + 1]);
+        }
+    };
+
+}
+
+#endif /* VertexAdjacency_hpp */
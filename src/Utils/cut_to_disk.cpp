@@ -1,7 +1,6 @@
 #include "cut_to_disk.hpp"
 
-#include <map>
-#include <set>
+#include <array>
 #include <deque>
 #include <algorithm>
 
@@ -18,64 +17,70 @@ namespace igl {
         if (nfaces == 0)
             return;
         
-        std::map<std::pair<Index, Index>, std::vector<Index> > edges;
-        // build edges
-        
+        // build edges from the sorted half-edges in flat arrays,
+        // sorting by (min vertex, max vertex, face) gives the same edge
+        // and adjacent face order as inserting them into an ordered map
+        std::vector<std::array<Index, 4> > halfedges(nfaces * 3);
         for (Index i = 0; i < nfaces; i++)
         {
             for (int j = 0; j < 3; j++)
             {
                 Index v0 = F(i, j);
                 Index v1 = F(i, (j + 1) % 3);
-                std::pair<Index, Index> e;
-                e.first = std::min(v0, v1);
-                e.second = std::max(v0, v1);
-                edges[e].push_back(i);
+                halfedges[i * 3 + j] = {{std::min(v0, v1), std::max(v0, v1), i, static_cast<Index>(j)}};
             }
         }
+        std::sort(halfedges.begin(), halfedges.end());
         
-        int nedges = edges.size();
-        Eigen::Matrix<Index, -1, -1> edgeVerts(nedges,2);
-        Eigen::Matrix<Index, -1, -1> edgeFaces(nedges,2);
-        Eigen::Matrix<Index, -1, -1> faceEdges(nfaces, 3);
-        std::set<Index> boundaryEdges;
-        std::map<std::pair<Index, Index>, Index> edgeidx;
-        Index idx = 0;
-        for (auto it : edges)
+        std::vector<Index> edgeVerts; // 2 per edge
+        std::vector<Index> edgeFaces; // 2 per edge, -1 for boundary edges
+        std::vector<Index> faceEdges(nfaces * 3);
+        std::vector<char> boundaryEdges;
+        Index nedges = 0;
+        for (size_t hI = 0; hI < halfedges.size(); )
         {
-            edgeidx[it.first] = idx;
-            edgeVerts(idx, 0) = it.first.first;
-            edgeVerts(idx, 1) = it.first.second;
-            edgeFaces(idx, 0) = it.second[0];
-            if (it.second.size() > 1)
-            {
-                edgeFaces(idx, 1) = it.second[1];
-            }
-            else
+            size_t hJ = hI;
+            while ((hJ < halfedges.size()) && (halfedges[hJ][0] == halfedges[hI][0]) &&
+                   (halfedges[hJ][1] == halfedges[hI][1]))
             {
-                edgeFaces(idx, 1) = -1;
-                boundaryEdges.insert(idx);
+                faceEdges[halfedges[hJ][2] * 3 + halfedges[hJ][3]] = nedges;
+                hJ++;
             }
-            idx++;
+            edgeVerts.push_back(halfedges[hI][0]);
+            edgeVerts.push_back(halfedges[hI][1]);
+            edgeFaces.push_back(halfedges[hI][2]);
+            edgeFaces.push_back((hJ - hI > 1) ? halfedges[hI + 1][2] : -1);
+            boundaryEdges.push_back(hJ - hI == 1);
+            nedges++;
+            hI = hJ;
         }
-        for (Index i = 0; i < nfaces; i++)
+        std::vector<std::array<Index, 4> >().swap(halfedges);
+        
+        // incident edges of each vertex in compressed rows, in the order of the given edges
+        Index nverts = F.maxCoeff() + 1;
+        auto vertEdgesOf = [&](const std::vector<Index>& edges,
+                               std::vector<Index>& offsets, std::vector<Index>& vertedges)
         {
-            for (int j = 0; j < 3; j++)
+            offsets.assign(nverts + 1, 0);
+            for (Index e : edges)
             {
-                Index v0 = F(i, j);
-                Index v1 = F(i, (j + 1) % 3);
-                std::pair<Index, Index> e;
-                e.first = std::min(v0, v1);
-                e.second = std::max(v0, v1);
-                faceEdges(i, j) = edgeidx[e];
+                offsets[edgeVerts[e * 2 + 0] + 1]++;
+                offsets[edgeVerts[e * 2 + 1] + 1]++;
             }
-        }
+            for (Index v = 0; v < nverts; v++)
+                offsets[v + 1] += offsets[v];
+            vertedges.resize(offsets[nverts]);
+            std::vector<Index> fill(offsets.begin(), offsets.end() - 1);
+            for (Index e : edges)
+            {
+                vertedges[fill[edgeVerts[e * 2 + 0]]++] = e;
+                vertedges[fill[edgeVerts[e * 2 + 1]]++] = e;
+            }
+        };
         
-        bool *deleted = new bool[nfaces];
-        for (Index i = 0; i < nfaces; i++)
-            deleted[i] = false;
+        std::vector<char> deleted(nfaces, false);
         
-        std::set<Index> deletededges;
+        std::vector<char> deletededges(nedges, false);
         
         // loop over faces
         for (Index face = 0; face < nfaces; face++)
@@ -87,13 +92,13 @@ namespace igl {
             std::deque<Index> processEdges;
             for (int i = 0; i < 3; i++)
             {
-                Index e = faceEdges(face, i);
-                if (boundaryEdges.count(e))
+                Index e = faceEdges[face * 3 + i];
+                if (boundaryEdges[e])
                     continue;
                 int ndeleted = 0;
-                if (deleted[edgeFaces(e, 0)])
+                if (deleted[edgeFaces[e * 2 + 0]])
                     ndeleted++;
-                if (deleted[edgeFaces(e, 1)])
+                if (deleted[edgeFaces[e * 2 + 1]])
                     ndeleted++;
                 if (ndeleted == 1)
                     processEdges.push_back(e);
@@ -104,23 +109,23 @@ namespace igl {
                 Index nexte = processEdges.front();
                 processEdges.pop_front();
                 Index todelete = nfaces;
-                if (!deleted[edgeFaces(nexte, 0)])
-                    todelete = edgeFaces(nexte, 0);
-                if (!deleted[edgeFaces(nexte, 1)])
-                    todelete = edgeFaces(nexte, 1);
+                if (!deleted[edgeFaces[nexte * 2 + 0]])
+                    todelete = edgeFaces[nexte * 2 + 0];
+                if (!deleted[edgeFaces[nexte * 2 + 1]])
+                    todelete = edgeFaces[nexte * 2 + 1];
                 if (todelete != nfaces)
                 {
-                    deletededges.insert(nexte);
+                    deletededges[nexte] = true;
                     deleted[todelete] = true;
                     for (int i = 0; i < 3; i++)
                     {
-                        Index e = faceEdges(todelete, i);
-                        if (boundaryEdges.count(e))
+                        Index e = faceEdges[todelete * 3 + i];
+                        if (boundaryEdges[e])
                             continue;
                         int ndeleted = 0;
-                        if (deleted[edgeFaces(e, 0)])
+                        if (deleted[edgeFaces[e * 2 + 0]])
                             ndeleted++;
-                        if (deleted[edgeFaces(e, 1)])
+                        if (deleted[edgeFaces[e * 2 + 1]])
                             ndeleted++;
                         if (ndeleted == 1)
                             processEdges.push_back(e);
@@ -128,48 +133,44 @@ namespace igl {
                 }
             }
         }
-        delete[] deleted;
         
         // accumulated non-deleted edges
         std::vector<Index> leftedges;
         for (Index i = 0; i < nedges; i++)
         {
-            if (!deletededges.count(i))
+            if (!deletededges[i])
                 leftedges.push_back(i);
         }
         
-        deletededges.clear();
+        deletededges.assign(nedges, false);
         // prune spines
-        std::map<Index, std::vector<Index> > spinevertedges;
-        for (Index i : leftedges)
-        {
-            spinevertedges[edgeVerts(i, 0)].push_back(i);
-            spinevertedges[edgeVerts(i, 1)].push_back(i);
-        }
+        std::vector<Index> spineoffsets, spinevertedges;
+        vertEdgesOf(leftedges, spineoffsets, spinevertedges);
         
         std::deque<Index> vertsProcess;
-        std::map<Index, int> spinevertnbs;
-        for (auto it : spinevertedges)
+        std::vector<int> spinevertnbs(nverts);
+        for (Index v = 0; v < nverts; v++)
         {
-            spinevertnbs[it.first] = it.second.size();
-            if (it.second.size() == 1)
-                vertsProcess.push_back(it.first);
+            spinevertnbs[v] = spineoffsets[v + 1] - spineoffsets[v];
+            if (spinevertnbs[v] == 1)
+                vertsProcess.push_back(v);
         }
         while (!vertsProcess.empty())
         {
             Index vert = vertsProcess.front();
             vertsProcess.pop_front();
-            for (Index e : spinevertedges[vert])
+            for (Index k = spineoffsets[vert]; k < spineoffsets[vert + 1]; k++)
             {
-                if (!deletededges.count(e))
+                Index e = spinevertedges[k];
+                if (!deletededges[e])
                 {
-                    deletededges.insert(e);
+                    deletededges[e] = true;
                     for (int j = 0; j < 2; j++)
                     {
-                        spinevertnbs[edgeVerts(e, j)]--;
-                        if (spinevertnbs[edgeVerts(e, j)] == 1)
+                        spinevertnbs[edgeVerts[e * 2 + j]]--;
+                        if (spinevertnbs[edgeVerts[e * 2 + j]] == 1)
                         {
-                            vertsProcess.push_back(edgeVerts(e, j));
+                            vertsProcess.push_back(edgeVerts[e * 2 + j]);
                         }
                     }
                 }
@@ -177,73 +178,70 @@ namespace igl {
         }
         std::vector<Index> loopedges;
         for (Index i : leftedges)
-            if (!deletededges.count(i))
+            if (!deletededges[i])
                 loopedges.push_back(i);
         
         Index nloopedges = loopedges.size();
         if (nloopedges == 0)
             return;
         
-        std::map<Index, std::vector<Index> > loopvertedges;
-        for (Index e : loopedges)
-        {
-            loopvertedges[edgeVerts(e, 0)].push_back(e);
-            loopvertedges[edgeVerts(e, 1)].push_back(e);
-        }
+        std::vector<Index> loopoffsets, loopvertedges;
+        vertEdgesOf(loopedges, loopoffsets, loopvertedges);
         
-        std::set<Index> usededges;
+        std::vector<char> usededges(nedges, false);
+        std::vector<Index> cycleidx(nverts, -1); // reset after each cycle or chain
         for (Index e : loopedges)
         {
             // make a cycle or chain starting from this edge
-            while (!usededges.count(e))
+            while (!usededges[e])
             {
                 std::vector<Index> cycleverts;
                 std::vector<Index> cycleedges;
-                cycleverts.push_back(edgeVerts(e, 0));
-                cycleverts.push_back(edgeVerts(e, 1));
+                cycleverts.push_back(edgeVerts[e * 2 + 0]);
+                cycleverts.push_back(edgeVerts[e * 2 + 1]);
                 cycleedges.push_back(e);
                 
-                std::map<Index, Index> cycleidx;
                 cycleidx[cycleverts[0]] = 0;
                 cycleidx[cycleverts[1]] = 1;
                 
-                Index curvert = edgeVerts(e, 1);
+                Index curvert = edgeVerts[e * 2 + 1];
                 Index cure = e;
                 bool foundcycle = false;
                 while (curvert != -1 && !foundcycle)
                 {
                     Index nextvert = -1;
                     Index nexte = -1;
-                    for (Index cande : loopvertedges[curvert])
+                    for (Index k = loopoffsets[curvert]; k < loopoffsets[curvert + 1]; k++)
                     {
-                        if (!usededges.count(cande) && cande != cure)
+                        Index cande = loopvertedges[k];
+                        if (!usededges[cande] && cande != cure)
                         {
                             int vidx = 0;
-                            if (curvert == edgeVerts(cande, vidx))
+                            if (curvert == edgeVerts[cande * 2 + vidx])
                                 vidx = 1;
-                            nextvert = edgeVerts(cande, vidx);
+                            nextvert = edgeVerts[cande * 2 + vidx];
                             nexte = cande;
                             break;
                         }
                     }
                     if (nextvert != -1)
                     {
-                        auto it = cycleidx.find(nextvert);
-                        if (it != cycleidx.end())
+                        Index cyclestart = cycleidx[nextvert];
+                        if (cyclestart != -1)
                         {
                             // we've hit outselves
                             std::vector<Index> cut;
-                            for (Index i = it->second; i < cycleverts.size(); i++)
+                            for (Index i = cyclestart; i < cycleverts.size(); i++)
                             {
                                 cut.push_back(cycleverts[i]);
                             }
                             cut.push_back(nextvert);
                             cuts.push_back(cut);
-                            for (Index i = it->second; i < cycleedges.size(); i++)
+                            for (Index i = cyclestart; i < cycleedges.size(); i++)
                             {
-                                usededges.insert(cycleedges[i]);
+                                usededges[cycleedges[i]] = true;
                             }
-                            usededges.insert(nexte);
+                            usededges[nexte] = true;
                             foundcycle = true;
                         }
                         else
@@ -267,36 +265,37 @@ namespace igl {
                     {
                         Index nextvert = -1;
                         Index nexte = -1;
-                        for (Index cande : loopvertedges[curvert])
+                        for (Index k = loopoffsets[curvert]; k < loopoffsets[curvert + 1]; k++)
                         {
-                            if (!usededges.count(cande) && cande != cure)
+                            Index cande = loopvertedges[k];
+                            if (!usededges[cande] && cande != cure)
                             {
                                 int vidx = 0;
-                                if (curvert == edgeVerts(cande, vidx))
+                                if (curvert == edgeVerts[cande * 2 + vidx])
                                     vidx = 1;
-                                nextvert = edgeVerts(cande, vidx);
+                                nextvert = edgeVerts[cande * 2 + vidx];
                                 nexte = cande;
                                 break;
                             }
                         }
                         if (nextvert != -1)
                         {
-                            auto it = cycleidx.find(nextvert);
-                            if (it != cycleidx.end())
+                            Index cyclestart = cycleidx[nextvert];
+                            if (cyclestart != -1)
                             {
                                 // we've hit outselves
-                                std::vector<int> cut;
-                                for (Index i = it->second; i < cycleverts.size(); i++)
+                                std::vector<Index> cut;
+                                for (Index i = cyclestart; i < cycleverts.size(); i++)
                                 {
                                     cut.push_back(cycleverts[i]);
                                 }
                                 cut.push_back(nextvert);
                                 cuts.push_back(cut);
-                                for (Index i = it->second; i < cycleedges.size(); i++)
+                                for (Index i = cyclestart; i < cycleedges.size(); i++)
                                 {
-                                    usededges.insert(cycleedges[i]);
+                                    usededges[cycleedges[i]] = true;
                                 }
-                                usededges.insert(nexte);
+                                usededges[nexte] = true;
                                 foundcycle = true;
                             }
                             else
@@ -320,10 +319,12 @@ namespace igl {
                         cuts.push_back(cut);
                         for (Index i = 0; i < cycleedges.size(); i++)
                         {
-                            usededges.insert(cycleedges[i]);
+                            usededges[cycleedges[i]] = true;
                         }
                     }
                 }
+                for (Index v : cycleverts)
+                    cycleidx[v] = -1;
             }
         }
     }
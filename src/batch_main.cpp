@@ -0,0 +1,128 @@
+#include <tbb/tbb.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Session.hpp"
+
+// runs many OptCuts jobs in one process: each non-empty line of the manifest (or of stdin)
+// holds the arguments of one OptCuts_bin run without the program name, '#' starts a comment,
+// up to jobAmt jobs are in flight at a time and all of them share one TBB arena
+//
+//     OptCuts_batch [-j jobAmt] [-t threadAmt] [manifest]
+
+int main(int argc, char* argv[])
+{
+    int jobAmt = 1;
+    int threadAmt = tbb::task_arena::automatic;
+    std::string manifestPath;
+    for (int argI = 1; argI < argc; argI++)
+    {
+        const std::string arg(argv[argI]);
+        if ((arg == "-j") && (argI + 1 < argc))
+        {
+            jobAmt = std::max(1, std::stoi(argv[++argI]));
+        }
+        else if ((arg == "-t") && (argI + 1 < argc))
+        {
+            threadAmt = std::max(1, std::stoi(argv[++argI]));
+        }
+        else if (arg != "-")
+        {
+            manifestPath = arg;
+        }
+    }
+
+    std::ifstream manifestFile;
+    if (!manifestPath.empty())
+    {
+        manifestFile.open(manifestPath);
+        if (!manifestFile.is_open())
+        {
+            std::cout << "failed to open manifest " << manifestPath << std::endl;
+            return -1;
+        }
+    }
+    std::istream& manifest = (manifestPath.empty() ? std::cin : manifestFile);
+
+    tbb::task_arena arena(threadAmt);
+    std::mutex mutex;  // guards the manifest, the counters and the summary lines
+    int jobI_next = 0, failedJobAmt = 0;
+
+    auto worker = [&]() {
+        while (true)
+        {
+            int jobI;
+            std::vector<std::string> args(1, "OptCuts_batch");
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                std::string line;
+                do
+                {
+                    if (!std::getline(manifest, line))
+                    {
+                        return;
+                    }
+                    line = line.substr(0, line.find('#'));
+                } while (line.find_first_not_of(" \t\r") == std::string::npos);
+
+                std::istringstream lineStream(line);
+                std::string arg;
+                while (lineStream >> arg)
+                {
+                    args.emplace_back(arg);
+                }
+                jobI = jobI_next++;
+                std::cout << "job " << jobI << " started: " << line << std::endl;
+            }
+
+            std::vector<char*> argv_job;
+            for (auto& argI : args)
+            {
+                argv_job.emplace_back(&argI[0]);
+            }
+
+            // the jobs' parallel loops run on the arena's threads
+            int exitCode = -1;
+            arena.execute([&]() {
+                try
+                {
+                    // the profiler is process-wide, its output would mix the jobs
+                    OptCuts::Session session;
+                    exitCode = session.runCommandLine(static_cast<int>(argv_job.size()), argv_job.data(), false);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cout << "job " << jobI << " threw " << e.what() << std::endl;
+                }
+            });
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::cout << "job " << jobI << " finished with exit code " << exitCode << std::endl;
+            if (exitCode != 0)
+            {
+                failedJobAmt++;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int workerI = 0; workerI < jobAmt; workerI++)
+    {
+        workers.emplace_back(worker);
+    }
+    for (auto& workerI : workers)
+    {
+        workerI.join();
+    }
+
+    std::cout << jobI_next << " jobs, " << failedJobAmt << " failed" << std::endl;
+    return (failedJobAmt > 0);
+}
@@ -0,0 +1,10 @@
+#include "Checks.hpp"
+
+// behavior checks, see src/UnitTest/Checks.hpp for the modes
+//
+//     OptCuts_checks checkMode [meshFilePath] [outputFolderPath]
+
+int main(int argc, char* argv[])
+{
+    return OptCuts::Checks::run(argc, argv);
+}